@@ -9,12 +9,40 @@ BUILDDIR="build/"
 EXTERNALDIR="external/"
 KERNELNAME="myos"
 
+# which block allocator to build malloc & co. on top of:
+# bitmap (first-fit, the default) or buddy, eg. `MM_BACKEND=buddy ./build.sh`
+MM_BACKEND="${MM_BACKEND:-bitmap}"
+case "$MM_BACKEND" in
+	bitmap|buddy) ;;
+	*) echo "unknown MM_BACKEND: $MM_BACKEND (expected bitmap or buddy)"; exit 1 ;;
+esac
+# set MM_TRACE_CALLERS=1 to record where allocations are made from,
+# see sdk/memstats.hpp
+if [ -n "$MM_TRACE_CALLERS" ]; then
+	CFLAGS_MM="$CFLAGS_MM -DMM_TRACE_CALLERS"
+fi
+# set MM_ZEROED_RAM=1 if memory is zeroed at boot (like in qemu),
+# so that calloc doesn't need to clear memory that's never been used
+if [ -n "$MM_ZEROED_RAM" ]; then
+	CFLAGS_MM="$CFLAGS_MM -DMM_ZEROED_RAM"
+fi
+# set POOL_STATS=1 to have sdk::util::Pool count how many objects it's
+# constructed and how many were live at once, see sdk/util.hpp
+if [ -n "$POOL_STATS" ]; then
+	CFLAGS_DEBUG="$CFLAGS_DEBUG -DSDK_POOL_STATS"
+fi
+# set SSE=1 to let the compiler use SSE2 (and do floating point with it
+# rather than the x87 FPU); the kernel will then need a Pentium 4 or newer
+if [ -n "$SSE" ]; then
+	CFLAGS_ARCH="-msse2 -mfpmath=sse"
+fi
+
 CC="$HOME/opt/cross/bin/i686-elf-g++"
 CFLAGS="-ffreestanding -Og -g"
 CFLAGS="$CFLAGS -Wall -Wextra"
 CFLAGS="$CFLAGS -fno-exceptions -fno-rtti"
 CFLAGS="$CFLAGS -I./include -I./external -isystem ./include/libk"
-CFLAGS="$CFLAGS -DKERNEL"
+CFLAGS="$CFLAGS -DKERNEL $CFLAGS_MM $CFLAGS_ARCH $CFLAGS_DEBUG"
 
 AS="$HOME/opt/cross/bin/i686-elf-as"
 
@@ -55,10 +83,14 @@ $CC $CFLAGS -c $SRCDIR/pit.cpp -o $BUILDDIR/pit.o
 OBJS="$OBJS $BUILDDIR/pit.o"
 $CC $CFLAGS -c $SRCDIR/ps2.cpp -o $BUILDDIR/ps2.o
 OBJS="$OBJS $BUILDDIR/ps2.o"
+$CC $CFLAGS -c $SRCDIR/serial.cpp -o $BUILDDIR/serial.o
+OBJS="$OBJS $BUILDDIR/serial.o"
 $CC $CFLAGS -c $SRCDIR/gdt.cpp -o $BUILDDIR/gdt.o
 OBJS="$OBJS $BUILDDIR/gdt.o"
 $CC $CFLAGS -c $SRCDIR/idt.cpp -o $BUILDDIR/idt.o
 OBJS="$OBJS $BUILDDIR/idt.o"
+$CC $CFLAGS -c $SRCDIR/multiboot.cpp -o $BUILDDIR/multiboot.o
+OBJS="$OBJS $BUILDDIR/multiboot.o"
 
 mkdir -p $BUILDDIR/apps
 
@@ -84,6 +116,10 @@ $CC $CFLAGS -c $SRCDIR/apps/calculator.cpp -o $BUILDDIR/apps/calculator.o
 OBJS="$OBJS $BUILDDIR/apps/calculator.o"
 $CC $CFLAGS -c $SRCDIR/apps/pi.cpp -o $BUILDDIR/apps/pi.o
 OBJS="$OBJS $BUILDDIR/apps/pi.o"
+$CC $CFLAGS -c $SRCDIR/apps/mem_inspector.cpp -o $BUILDDIR/apps/mem_inspector.o
+OBJS="$OBJS $BUILDDIR/apps/mem_inspector.o"
+$CC $CFLAGS -c $SRCDIR/apps/benchmark.cpp -o $BUILDDIR/apps/benchmark.o
+OBJS="$OBJS $BUILDDIR/apps/benchmark.o"
 
 $CC $CFLAGS -c $SRCDIR/apps/components/menu.cpp -o $BUILDDIR/apps/component-menu.o
 OBJS="$OBJS $BUILDDIR/apps/component-menu.o"
@@ -97,8 +133,14 @@ OBJS="$OBJS $BUILDDIR/external/mieliepit.o"
 
 mkdir -p $BUILDDIR/sdk
 
+$CC $CFLAGS -c $SRCDIR/libk/sdk/arena.cpp -o $BUILDDIR/sdk/arena.o
+OBJS="$OBJS $BUILDDIR/sdk/arena.o"
 $CC $CFLAGS -c $SRCDIR/libk/sdk/eventloop.cpp -o $BUILDDIR/sdk/eventloop.o
 OBJS="$OBJS $BUILDDIR/sdk/eventloop.o"
+$CC $CFLAGS -c $SRCDIR/libk/sdk/fmt.cpp -o $BUILDDIR/sdk/fmt.o
+OBJS="$OBJS $BUILDDIR/sdk/fmt.o"
+$CC $CFLAGS -c $SRCDIR/libk/sdk/memstats.cpp -o $BUILDDIR/sdk/memstats.o
+OBJS="$OBJS $BUILDDIR/sdk/memstats.o"
 $CC $CFLAGS -c $SRCDIR/libk/sdk/random.cpp -o $BUILDDIR/sdk/random.o
 OBJS="$OBJS $BUILDDIR/sdk/random.o"
 $CC $CFLAGS -c $SRCDIR/libk/sdk/terminal.cpp -o $BUILDDIR/sdk/terminal.o
@@ -111,6 +153,10 @@ LIBK_OBJS=""
 # For adding objects (vim, replace stdio with relevant header):
 # '<,'>s/\(.*\)\.cpp/$CC $CFLAGS -c $SRCDIR\/libk\/stdio\/\1.cpp -o $BUILDDIR\/libk-stdio-\1.o\rLIBK_OBJS="$LIBK_OBJS $BUILDDIR\/libk-stdio-\1.o"
 
+$CC $CFLAGS -c $SRCDIR/libk/string/_string_internals.cpp -o $BUILDDIR/libk-string-_string_internals.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-string-_string_internals.o"
+$CC $CFLAGS -c $SRCDIR/libk/string/memchr.cpp -o $BUILDDIR/libk-string-memchr.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-string-memchr.o"
 $CC $CFLAGS -c $SRCDIR/libk/string/memcmp.cpp -o $BUILDDIR/libk-string-memcmp.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-string-memcmp.o"
 $CC $CFLAGS -c $SRCDIR/libk/string/memcpy.cpp -o $BUILDDIR/libk-string-memcpy.o
@@ -119,6 +165,12 @@ $CC $CFLAGS -c $SRCDIR/libk/string/memmove.cpp -o $BUILDDIR/libk-string-memmove.
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-string-memmove.o"
 $CC $CFLAGS -c $SRCDIR/libk/string/memset.cpp -o $BUILDDIR/libk-string-memset.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-string-memset.o"
+$CC $CFLAGS -c $SRCDIR/libk/string/memset16.cpp -o $BUILDDIR/libk-string-memset16.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-string-memset16.o"
+$CC $CFLAGS -c $SRCDIR/libk/string/memset32.cpp -o $BUILDDIR/libk-string-memset32.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-string-memset32.o"
+$CC $CFLAGS -c $SRCDIR/libk/string/strchr.cpp -o $BUILDDIR/libk-string-strchr.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-string-strchr.o"
 $CC $CFLAGS -c $SRCDIR/libk/string/strcmp.cpp -o $BUILDDIR/libk-string-strcmp.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-string-strcmp.o"
 $CC $CFLAGS -c $SRCDIR/libk/string/strncmp.cpp -o $BUILDDIR/libk-string-strncmp.o
@@ -126,27 +178,69 @@ LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-string-strncmp.o"
 $CC $CFLAGS -c $SRCDIR/libk/string/strlen.cpp -o $BUILDDIR/libk-string-strlen.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-string-strlen.o"
 
+$CC $CFLAGS -c $SRCDIR/libk/stdio/_format.cpp -o $BUILDDIR/libk-stdio-_format.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-_format.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdio/_streams.cpp -o $BUILDDIR/libk-stdio-_streams.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-_streams.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdio/fflush.cpp -o $BUILDDIR/libk-stdio-fflush.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-fflush.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdio/fprintf.cpp -o $BUILDDIR/libk-stdio-fprintf.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-fprintf.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdio/fputc.cpp -o $BUILDDIR/libk-stdio-fputc.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-fputc.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdio/fputs.cpp -o $BUILDDIR/libk-stdio-fputs.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-fputs.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdio/fwrite.cpp -o $BUILDDIR/libk-stdio-fwrite.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-fwrite.o"
 $CC $CFLAGS -c $SRCDIR/libk/stdio/printf.cpp -o $BUILDDIR/libk-stdio-printf.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-printf.o"
 $CC $CFLAGS -c $SRCDIR/libk/stdio/putchar.cpp -o $BUILDDIR/libk-stdio-putchar.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-putchar.o"
 $CC $CFLAGS -c $SRCDIR/libk/stdio/puts.cpp -o $BUILDDIR/libk-stdio-puts.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-puts.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdio/ring_log_read.cpp -o $BUILDDIR/libk-stdio-ring_log_read.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-ring_log_read.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdio/setvbuf.cpp -o $BUILDDIR/libk-stdio-setvbuf.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-setvbuf.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdio/snprintf.cpp -o $BUILDDIR/libk-stdio-snprintf.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-snprintf.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdio/vfprintf.cpp -o $BUILDDIR/libk-stdio-vfprintf.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-vfprintf.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdio/vprintf.cpp -o $BUILDDIR/libk-stdio-vprintf.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-vprintf.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdio/vsnprintf.cpp -o $BUILDDIR/libk-stdio-vsnprintf.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdio-vsnprintf.o"
 
 $CC $CFLAGS -c $SRCDIR/libk/stdlib/_mm_internals.cpp -o $BUILDDIR/libk-stdlib-_mm_internals.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-_mm_internals.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdlib/_mm_$MM_BACKEND.cpp -o $BUILDDIR/libk-stdlib-_mm_backend.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-_mm_backend.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdlib/_mm_slab.cpp -o $BUILDDIR/libk-stdlib-_mm_slab.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-_mm_slab.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdlib/_mm_stats.cpp -o $BUILDDIR/libk-stdlib-_mm_stats.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-_mm_stats.o"
 $CC $CFLAGS -c $SRCDIR/libk/stdlib/abort.cpp -o $BUILDDIR/libk-stdlib-abort.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-abort.o"
 $CC $CFLAGS -c $SRCDIR/libk/stdlib/calloc.cpp -o $BUILDDIR/libk-stdlib-calloc.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-calloc.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdlib/dtoa.cpp -o $BUILDDIR/libk-stdlib-dtoa.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-dtoa.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdlib/dtoa_fixed.cpp -o $BUILDDIR/libk-stdlib-dtoa_fixed.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-dtoa_fixed.o"
 $CC $CFLAGS -c $SRCDIR/libk/stdlib/free.cpp -o $BUILDDIR/libk-stdlib-free.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-free.o"
 $CC $CFLAGS -c $SRCDIR/libk/stdlib/malloc.cpp -o $BUILDDIR/libk-stdlib-malloc.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-malloc.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdlib/malloc_usable_size.cpp -o $BUILDDIR/libk-stdlib-malloc_usable_size.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-malloc_usable_size.o"
 $CC $CFLAGS -c $SRCDIR/libk/stdlib/reallocarray.cpp -o $BUILDDIR/libk-stdlib-reallocarray.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-reallocarray.o"
 $CC $CFLAGS -c $SRCDIR/libk/stdlib/realloc.cpp -o $BUILDDIR/libk-stdlib-realloc.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-realloc.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdlib/utoa32.cpp -o $BUILDDIR/libk-stdlib-utoa32.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-utoa32.o"
+$CC $CFLAGS -c $SRCDIR/libk/stdlib/utoa64.cpp -o $BUILDDIR/libk-stdlib-utoa64.o
+LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-stdlib-utoa64.o"
 
 $CC $CFLAGS -c $SRCDIR/libk/assert/_assert_fail.cpp -o $BUILDDIR/libk-assert-_assert_fail.o
 LIBK_OBJS="$LIBK_OBJS $BUILDDIR/libk-assert-_assert_fail.o"
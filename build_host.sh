@@ -0,0 +1,108 @@
+#!/bin/sh
+
+set -x -e
+
+# builds libk's string & stdlib functions and the parts of the SDK that
+# don't touch hardware as an ordinary Linux program, with a test runner
+# and benchmarks against glibc (see host/), eg.
+# `./build_host.sh && build/host/libk_host test`
+
+SRCDIR="src/"
+HOSTDIR="host/"
+BUILDDIR="build/host/"
+PROGNAME="libk_host"
+
+# same as in build.sh
+MM_BACKEND="${MM_BACKEND:-bitmap}"
+case "$MM_BACKEND" in
+	bitmap|buddy) ;;
+	*) echo "unknown MM_BACKEND: $MM_BACKEND (expected bitmap or buddy)"; exit 1 ;;
+esac
+
+CC="${HOST_CC:-g++}"
+# libk is built against its own headers, just like in the kernel, and
+# loop idioms mustn't be turned into calls to the very functions
+# implementing them
+CFLAGS="-ffreestanding -fno-builtin -fno-tree-loop-distribute-patterns -O2 -g"
+CFLAGS="$CFLAGS -Wall -Wextra"
+CFLAGS="$CFLAGS -fno-exceptions -fno-rtti"
+CFLAGS="$CFLAGS -I./include -isystem ./include/libk"
+
+LD="$CC"
+LDFLAGS=""
+
+# libk's C functions are renamed to k_<name> after compiling, so that
+# they sit alongside glibc's instead of replacing them
+OBJCOPY="${HOST_OBJCOPY:-objcopy}"
+RENAME="--redefine-syms=$HOSTDIR/libk.syms"
+
+mkdir -p $BUILDDIR
+
+OBJS=""
+
+compile() {
+	$CC $CFLAGS -c "$1" -o "$2"
+	$OBJCOPY $RENAME "$2"
+	OBJS="$OBJS $2"
+}
+
+compile $SRCDIR/libk/string/_string_internals.cpp $BUILDDIR/libk-string-_string_internals.o
+compile $SRCDIR/libk/string/memchr.cpp $BUILDDIR/libk-string-memchr.o
+compile $SRCDIR/libk/string/memcmp.cpp $BUILDDIR/libk-string-memcmp.o
+compile $SRCDIR/libk/string/memcpy.cpp $BUILDDIR/libk-string-memcpy.o
+compile $SRCDIR/libk/string/memmove.cpp $BUILDDIR/libk-string-memmove.o
+compile $SRCDIR/libk/string/memset.cpp $BUILDDIR/libk-string-memset.o
+compile $SRCDIR/libk/string/memset16.cpp $BUILDDIR/libk-string-memset16.o
+compile $SRCDIR/libk/string/memset32.cpp $BUILDDIR/libk-string-memset32.o
+compile $SRCDIR/libk/string/strchr.cpp $BUILDDIR/libk-string-strchr.o
+compile $SRCDIR/libk/string/strcmp.cpp $BUILDDIR/libk-string-strcmp.o
+compile $SRCDIR/libk/string/strncmp.cpp $BUILDDIR/libk-string-strncmp.o
+compile $SRCDIR/libk/string/strlen.cpp $BUILDDIR/libk-string-strlen.o
+
+# printf, putchar and puts themselves are stood in for (see below), but
+# the rest is the real thing, with the terminal and serial port shimmed
+compile $SRCDIR/libk/stdio/_format.cpp $BUILDDIR/libk-stdio-_format.o
+compile $SRCDIR/libk/stdio/_streams.cpp $BUILDDIR/libk-stdio-_streams.o
+compile $SRCDIR/libk/stdio/fflush.cpp $BUILDDIR/libk-stdio-fflush.o
+compile $SRCDIR/libk/stdio/fprintf.cpp $BUILDDIR/libk-stdio-fprintf.o
+compile $SRCDIR/libk/stdio/fputc.cpp $BUILDDIR/libk-stdio-fputc.o
+compile $SRCDIR/libk/stdio/fputs.cpp $BUILDDIR/libk-stdio-fputs.o
+compile $SRCDIR/libk/stdio/fwrite.cpp $BUILDDIR/libk-stdio-fwrite.o
+compile $SRCDIR/libk/stdio/ring_log_read.cpp $BUILDDIR/libk-stdio-ring_log_read.o
+compile $SRCDIR/libk/stdio/setvbuf.cpp $BUILDDIR/libk-stdio-setvbuf.o
+compile $SRCDIR/libk/stdio/snprintf.cpp $BUILDDIR/libk-stdio-snprintf.o
+compile $SRCDIR/libk/stdio/vfprintf.cpp $BUILDDIR/libk-stdio-vfprintf.o
+compile $SRCDIR/libk/stdio/vsnprintf.cpp $BUILDDIR/libk-stdio-vsnprintf.o
+
+compile $SRCDIR/libk/stdlib/_mm_internals.cpp $BUILDDIR/libk-stdlib-_mm_internals.o
+compile $SRCDIR/libk/stdlib/_mm_$MM_BACKEND.cpp $BUILDDIR/libk-stdlib-_mm_backend.o
+compile $SRCDIR/libk/stdlib/_mm_slab.cpp $BUILDDIR/libk-stdlib-_mm_slab.o
+compile $SRCDIR/libk/stdlib/_mm_stats.cpp $BUILDDIR/libk-stdlib-_mm_stats.o
+compile $SRCDIR/libk/stdlib/calloc.cpp $BUILDDIR/libk-stdlib-calloc.o
+compile $SRCDIR/libk/stdlib/dtoa.cpp $BUILDDIR/libk-stdlib-dtoa.o
+compile $SRCDIR/libk/stdlib/dtoa_fixed.cpp $BUILDDIR/libk-stdlib-dtoa_fixed.o
+compile $SRCDIR/libk/stdlib/free.cpp $BUILDDIR/libk-stdlib-free.o
+compile $SRCDIR/libk/stdlib/malloc.cpp $BUILDDIR/libk-stdlib-malloc.o
+compile $SRCDIR/libk/stdlib/malloc_usable_size.cpp $BUILDDIR/libk-stdlib-malloc_usable_size.o
+compile $SRCDIR/libk/stdlib/reallocarray.cpp $BUILDDIR/libk-stdlib-reallocarray.o
+compile $SRCDIR/libk/stdlib/realloc.cpp $BUILDDIR/libk-stdlib-realloc.o
+compile $SRCDIR/libk/stdlib/utoa32.cpp $BUILDDIR/libk-stdlib-utoa32.o
+compile $SRCDIR/libk/stdlib/utoa64.cpp $BUILDDIR/libk-stdlib-utoa64.o
+
+compile $SRCDIR/libk/sdk/arena.cpp $BUILDDIR/sdk-arena.o
+compile $SRCDIR/libk/sdk/fmt.cpp $BUILDDIR/sdk-fmt.o
+compile $SRCDIR/libk/sdk/random.cpp $BUILDDIR/sdk-random.o
+compile $SRCDIR/libk/sdk/util.cpp $BUILDDIR/sdk-util.o
+
+# stand-ins for abort, printf, the terminal, etc.
+compile $HOSTDIR/shims.cpp $BUILDDIR/host-shims.o
+compile $HOSTDIR/tests.cpp $BUILDDIR/host-tests.o
+compile $HOSTDIR/bench.cpp $BUILDDIR/host-bench.o
+compile $HOSTDIR/main.cpp $BUILDDIR/host-main.o
+
+# glibc's functions under host_<name>, to compare against: built against
+# the system headers, and not renamed
+$CC -O2 -g -fno-builtin -Wall -Wextra -c $HOSTDIR/glibc.cpp -o $BUILDDIR/host-glibc.o
+OBJS="$OBJS $BUILDDIR/host-glibc.o"
+
+$LD $LDFLAGS -o "$BUILDDIR/$PROGNAME" $OBJS
@@ -0,0 +1,219 @@
+// times libk's string functions and allocator against glibc's, in cycles
+// per call (the same way the kernel's benchmark app measures things)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host.hpp"
+
+namespace host {
+
+namespace {
+
+constexpr size_t MAX_SIZE = 64*1024;
+
+// with room for offsetting the source, so that it's misaligned
+alignas(64) uint8_t src[MAX_SIZE + 64];
+alignas(64) uint8_t dst[MAX_SIZE + 64];
+alignas(64) char str_a[MAX_SIZE + 64];
+alignas(64) char str_b[MAX_SIZE + 64];
+
+// enough iterations for each case to take a while, whatever its size
+size_t iterations(size_t size) {
+	const size_t iters = (64*1024*1024) / (size + 64);
+	return iters < 100 ? 100 : iters;
+}
+
+template<typename Fn>
+uint64_t time_per_call(size_t iters, Fn fn) {
+	// warm the caches up first
+	for (size_t i = 0; i < iters/16 + 1; ++i) fn();
+
+	const uint64_t begin = rdtsc();
+	for (size_t i = 0; i < iters; ++i) fn();
+	return (rdtsc() - begin) / iters;
+}
+
+void report(const char *name, size_t size, uint64_t libk, uint64_t glibc) {
+	if (size) printf("  %-10s %6zu B", name, size);
+	else printf("  %-10s   mixed", name);
+	printf("  libk %8llu  glibc %8llu  (%5.2fx)\n",
+		(unsigned long long)libk, (unsigned long long)glibc,
+		glibc ? double(libk) / double(glibc) : 0.0
+	);
+}
+
+constexpr size_t SIZES[] = { 8, 32, 128, 1024, 4096, MAX_SIZE };
+
+void bench_mem() {
+	puts("memory functions (cycles per call):");
+
+	for (const size_t size : SIZES) {
+		const size_t iters = iterations(size);
+		report("memcpy", size,
+			time_per_call(iters, [=]() { keep(memcpy(dst, src + 1, size)); }),
+			time_per_call(iters, [=]() { keep(host_memcpy(dst, src + 1, size)); })
+		);
+	}
+	for (const size_t size : SIZES) {
+		const size_t iters = iterations(size);
+		report("memmove", size,
+			time_per_call(iters, [=]() { keep(memmove(dst + 3, dst, size)); }),
+			time_per_call(iters, [=]() { keep(host_memmove(dst + 3, dst, size)); })
+		);
+	}
+	for (const size_t size : SIZES) {
+		const size_t iters = iterations(size);
+		report("memset", size,
+			time_per_call(iters, [=]() { keep(memset(dst + 1, 0x55, size)); }),
+			time_per_call(iters, [=]() { keep(host_memset(dst + 1, 0x55, size)); })
+		);
+	}
+
+	host_memcpy(dst, src, MAX_SIZE);
+	for (const size_t size : SIZES) {
+		const size_t iters = iterations(size);
+		report("memcmp", size,
+			time_per_call(iters, [=]() { keep(memcmp(dst, src, size)); }),
+			time_per_call(iters, [=]() { keep(host_memcmp(dst, src, size)); })
+		);
+	}
+}
+
+void bench_str() {
+	puts("string functions (cycles per call):");
+
+	host_memset(str_a, 'x', sizeof(str_a));
+	host_memset(str_b, 'x', sizeof(str_b));
+
+	for (const size_t size : SIZES) {
+		const size_t iters = iterations(size);
+		str_a[size] = 0;
+		str_b[size + 1] = 0;
+		report("strlen", size,
+			time_per_call(iters, [=]() { keep(strlen(str_a)); }),
+			time_per_call(iters, [=]() { keep(host_strlen(str_a)); })
+		);
+		report("strcmp", size,
+			time_per_call(iters, [=]() { keep(strcmp(str_a, str_b + 1)); }),
+			time_per_call(iters, [=]() { keep(host_strcmp(str_a, str_b + 1)); })
+		);
+		report("strchr", size,
+			time_per_call(iters, [=]() { keep(strchr(str_a, 'y')); }),
+			time_per_call(iters, [=]() { keep(host_strchr(str_a, 'y')); })
+		);
+		str_a[size] = 'x';
+		str_b[size + 1] = 'x';
+	}
+}
+
+// glibc has no plain number to string functions, so these are up against
+// its snprintf
+void bench_conv() {
+	puts("number conversions (cycles per call, mixed sizes):");
+
+	constexpr size_t NUM_VALUES = 1024;
+	static uint64_t ints[NUM_VALUES];
+	static double doubles[NUM_VALUES];
+	uint32_t state = 1;
+	for (size_t i = 0; i < NUM_VALUES; ++i) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		// all lengths equally often
+		ints[i] = ((uint64_t(state) << 32) | (state * 2654435761u)) >> (i % 64);
+		doubles[i] = double(ints[i]) / double(state | 1);
+	}
+
+	char buf[64];
+	size_t i = 0;
+	const size_t iters = 200000;
+	report("utoa32", 0,
+		time_per_call(iters, [&]() { keep(utoa32(ints[i++ % NUM_VALUES], buf)); }),
+		time_per_call(iters, [&]() { keep(host_snprintf(buf, sizeof(buf), "%u", uint32_t(ints[i++ % NUM_VALUES]))); })
+	);
+	report("utoa64", 0,
+		time_per_call(iters, [&]() { keep(utoa64(ints[i++ % NUM_VALUES], buf)); }),
+		time_per_call(iters, [&]() { keep(host_snprintf(buf, sizeof(buf), "%llu", (unsigned long long)ints[i++ % NUM_VALUES])); })
+	);
+	report("dtoa", 0,
+		time_per_call(iters, [&]() { keep(dtoa(doubles[i++ % NUM_VALUES], buf)); }),
+		time_per_call(iters, [&]() { keep(host_snprintf(buf, sizeof(buf), "%.17g", doubles[i++ % NUM_VALUES])); })
+	);
+	report("dtoa_fixed", 0,
+		time_per_call(iters, [&]() { keep(dtoa_fixed(doubles[i++ % NUM_VALUES], 6, buf)); }),
+		time_per_call(iters, [&]() { keep(host_snprintf(buf, sizeof(buf), "%f", doubles[i++ % NUM_VALUES])); })
+	);
+}
+
+void bench_malloc() {
+	puts("allocator (cycles per malloc + free):");
+
+	constexpr size_t ALLOC_SIZES[] = { 16, 100, 1000, 8*1024, 64*1024 };
+	for (const size_t size : ALLOC_SIZES) {
+		const size_t iters = 100000;
+		report("malloc", size,
+			time_per_call(iters, [=]() {
+				void *p = malloc(size);
+				keep(p);
+				free(p);
+			}),
+			time_per_call(iters, [=]() {
+				void *p = host_malloc(size);
+				keep(p);
+				host_free(p);
+			})
+		);
+	}
+
+	// a heap with lots of live allocations of mixed sizes, being churned
+	// through, which is closer to what the apps do
+	constexpr size_t NUM_LIVE = 512;
+	void *live[NUM_LIVE] = {};
+	uint32_t state = 1;
+	const auto next = [&state]() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	};
+	const auto churn_size = [&next]() -> size_t {
+		return next() % 8 ? next() % 128 : next() % 4096;
+	};
+
+	const size_t iters = 200000;
+	const uint64_t libk = time_per_call(iters, [&]() {
+		void *&p = live[next() % NUM_LIVE];
+		free(p);
+		p = malloc(churn_size());
+	});
+	for (auto &p : live) { free(p); p = nullptr; }
+
+	state = 1;
+	const uint64_t glibc = time_per_call(iters, [&]() {
+		void *&p = live[next() % NUM_LIVE];
+		host_free(p);
+		p = host_malloc(churn_size());
+	});
+	for (auto &p : live) { host_free(p); p = nullptr; }
+
+	report("churn", 0, libk, glibc);
+}
+
+}
+
+void run_benchmarks() {
+	printf("string functions use %s, memcpy %s rep movsb\n",
+		_string_internals::use_sse2 ? "SSE2" : "plain x86",
+		_string_internals::use_rep_movsb ? "uses" : "doesn't use"
+	);
+	printf("block allocator: %s\n", _mm_internals::backend_name);
+
+	bench_mem();
+	bench_str();
+	bench_conv();
+	bench_malloc();
+}
+
+}
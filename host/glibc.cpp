@@ -0,0 +1,42 @@
+// glibc's versions of what libk has, under host_<name> (see host.hpp).
+// Unlike everything else here this is built against the system headers,
+// and isn't renamed
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+extern "C" {
+
+void *host_malloc(size_t size) { return malloc(size); }
+void *host_calloc(size_t n, size_t size) { return calloc(n, size); }
+void *host_realloc(void *p, size_t size) { return realloc(p, size); }
+void host_free(void *p) { free(p); }
+void *host_aligned_alloc(size_t align, size_t size) { return aligned_alloc(align, size); }
+
+int host_memcmp(const void *a, const void *b, size_t n) { return memcmp(a, b, n); }
+void *host_memchr(const void *p, int c, size_t n) { return (void*)memchr(p, c, n); }
+void *host_memcpy(void *dst, const void *src, size_t n) { return memcpy(dst, src, n); }
+void *host_memmove(void *dst, const void *src, size_t n) { return memmove(dst, src, n); }
+void *host_memset(void *p, int c, size_t n) { return memset(p, c, n); }
+char *host_strchr(const char *s, int c) { return (char*)strchr(s, c); }
+int host_strcmp(const char *a, const char *b) { return strcmp(a, b); }
+int host_strncmp(const char *a, const char *b, size_t n) { return strncmp(a, b, n); }
+size_t host_strlen(const char *s) { return strlen(s); }
+double host_strtod(const char *s, char **end) { return strtod(s, end); }
+
+int host_vprintf(const char *format, va_list args) { return vprintf(format, args); }
+int host_snprintf(char *buf, size_t size, const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	const int res = vsnprintf(buf, size, format, args);
+	va_end(args);
+	return res;
+}
+int host_fflush(void *file) { return fflush((FILE*)file); }
+long host_write(int fd, const void *data, size_t size) { return write(fd, data, size); }
+void host_abort(void) { abort(); }
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Everything under host/ is compiled against libk's headers, just like the
+// kernel, and then has libk's C functions renamed to k_<name> (see
+// libk.syms and build_host.sh), so that they don't replace glibc's.
+// glibc's versions are declared here under host_<name> instead, to
+// compare against. They're defined in glibc.cpp, which is built against
+// the system headers and isn't renamed (an asm label naming glibc's
+// symbol directly would get renamed to libk's along with everything else).
+
+extern "C" {
+
+void *host_malloc(size_t);
+void *host_calloc(size_t, size_t);
+void *host_realloc(void *, size_t);
+void host_free(void *);
+void *host_aligned_alloc(size_t, size_t);
+
+int host_memcmp(const void *, const void *, size_t);
+void *host_memchr(const void *, int, size_t);
+void *host_memcpy(void *, const void *, size_t);
+void *host_memmove(void *, const void *, size_t);
+void *host_memset(void *, int, size_t);
+char *host_strchr(const char *, int);
+int host_strcmp(const char *, const char *);
+int host_strncmp(const char *, const char *, size_t);
+size_t host_strlen(const char *);
+double host_strtod(const char *, char **);
+
+int host_vprintf(const char *, va_list);
+int host_snprintf(char *, size_t, const char *, ...);
+int host_fflush(void *);
+long host_write(int, const void *, size_t);
+__attribute__((__noreturn__)) void host_abort(void);
+
+}
+
+namespace host {
+
+// the heap libk's malloc & co. hand out memory from, set up by main
+constexpr size_t HEAP_SIZE = 16*1024*1024;
+
+inline uint64_t rdtsc() {
+	uint32_t lo, hi;
+	__asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+	return (uint64_t(hi) << 32) | lo;
+}
+
+// keep the compiler from optimising away a result that's never used
+template<typename T>
+inline void keep(const T &value) {
+	__asm__ volatile("" : : "r,m"(value) : "memory");
+}
+
+// returns the number of failed checks
+size_t run_tests();
+void run_benchmarks();
+
+}
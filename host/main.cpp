@@ -0,0 +1,46 @@
+// libk (and parts of the SDK) built as an ordinary Linux program, to test
+// and benchmark them without booting the kernel; see build_host.sh.
+//
+// Usage: build/host/libk_host [test|bench]
+// (with no arguments, runs the tests and then the benchmarks)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cpuid.h>
+
+#include "host.hpp"
+
+extern "C" uint32_t fpu_cpu_features;
+
+namespace {
+
+alignas(4096) uint8_t heap[host::HEAP_SIZE];
+
+}
+
+int main(int argc, char **argv) {
+	uint32_t eax, ebx, ecx, edx;
+	if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) fpu_cpu_features = edx;
+	_string_internals::init();
+
+	const _mm_internals::mem_range_t usable = {
+		(uintptr_t)&heap[0],
+		(uintptr_t)&heap[host::HEAP_SIZE],
+	};
+	_mm_internals::init(&usable, 1);
+
+	const bool tests = argc < 2 || strcmp(argv[1], "test") == 0;
+	const bool benchmarks = argc < 2 || strcmp(argv[1], "bench") == 0;
+	if (!tests && !benchmarks) {
+		printf("usage: %s [test|bench]\n", argv[0]);
+		return 2;
+	}
+
+	size_t failures = 0;
+	if (tests) failures = host::run_tests();
+	if (benchmarks) host::run_benchmarks();
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,62 @@
+// the bits of the kernel that libk leans on, done with glibc instead
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pit.hpp"
+#include "serial.hpp"
+#include "vga.hpp"
+
+#include "host.hpp"
+
+volatile uint32_t pit::millis = 1;
+
+// normally set in boot.s, see include/fpu.hpp; main fills it in
+extern "C" uint32_t fpu_cpu_features;
+uint32_t fpu_cpu_features = 0;
+
+namespace term {
+
+void write(const char *data, size_t size) {
+	host_write(1, data, size);
+}
+
+}
+
+// the serial port goes to stderr
+namespace serial {
+
+void write(const char *data, size_t size) {
+	host_write(2, data, size);
+}
+
+}
+
+// printf just hands over to glibc, only puts and putchar are really
+// needed, but this way printf can be used for output here
+int printf(const char *__restrict format, ...) {
+	va_list args;
+	va_start(args, format);
+	const int res = host_vprintf(format, args);
+	va_end(args);
+	return res;
+}
+int putchar(int ic) {
+	printf("%c", ic);
+	return ic;
+}
+int puts(const char *str) {
+	return printf("%s\n", str);
+}
+
+void abort(void) {
+	host_fflush(nullptr);
+	host_abort();
+}
+
+void _assert_fail(const char *assertion, const char *file, int line, const char *func) {
+	printf("%s:%d: %s: Assertion `%s` failed.\n", file, line, func, assertion);
+	abort();
+}
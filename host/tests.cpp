@@ -0,0 +1,636 @@
+// checks libk's string functions and allocator against glibc, and the
+// SDK's containers against what they're supposed to hold
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sdk/arena.hpp>
+#include <sdk/fmt.hpp>
+#include <sdk/random.hpp>
+#include <sdk/util.hpp>
+
+#include "host.hpp"
+
+namespace host {
+
+namespace {
+
+using namespace sdk::util;
+
+size_t failures = 0;
+size_t checks = 0;
+
+#define CHECK(expr) do { \
+		++checks; \
+		if (!(expr)) { \
+			++failures; \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+		} \
+	} while (0)
+
+int sign(int x) {
+	return (x > 0) - (x < 0);
+}
+
+// the same sequence every run, so failures can be reproduced
+sdk::random::Xorshift32 rng(1234);
+size_t rand_below(size_t n) {
+	return rng.next() % n;
+}
+
+constexpr size_t MAX_LEN = 300;
+constexpr size_t TRIALS = 20000;
+// room for the longest string at any alignment, plus slack either side
+constexpr size_t BUF_SIZE = 2*MAX_LEN + 64;
+
+uint8_t buf_a[BUF_SIZE];
+uint8_t buf_b[BUF_SIZE];
+uint8_t buf_ref[BUF_SIZE];
+
+void fill_random(uint8_t *p, size_t n) {
+	for (size_t i = 0; i < n; ++i) p[i] = rng.next();
+}
+// strings from a small alphabet, so that they often share prefixes
+void fill_string(char *p, size_t n) {
+	for (size_t i = 0; i < n; ++i) p[i] = 'a' + rand_below(3);
+	p[n] = 0;
+}
+
+void test_mem() {
+	for (size_t trial = 0; trial < TRIALS; ++trial) {
+		const size_t n = rand_below(MAX_LEN);
+		const size_t da = rand_below(32);
+		const size_t sa = rand_below(32);
+
+		fill_random(buf_a, BUF_SIZE);
+		fill_random(buf_b, BUF_SIZE);
+		host_memcpy(buf_ref, buf_a, BUF_SIZE);
+
+		memcpy(buf_a + da, buf_b + sa, n);
+		host_memcpy(buf_ref + da, buf_b + sa, n);
+		CHECK(host_memcmp(buf_a, buf_ref, BUF_SIZE) == 0);
+
+		// overlapping, in either direction
+		const size_t to = rand_below(MAX_LEN);
+		const size_t from = rand_below(MAX_LEN);
+		memmove(buf_a + to, buf_a + from, n);
+		host_memmove(buf_ref + to, buf_ref + from, n);
+		CHECK(host_memcmp(buf_a, buf_ref, BUF_SIZE) == 0);
+
+		const int c = rng.next();
+		memset(buf_a + da, c, n);
+		host_memset(buf_ref + da, c, n);
+		CHECK(host_memcmp(buf_a, buf_ref, BUF_SIZE) == 0);
+
+		const uint16_t v16 = rng.next();
+		memset16(buf_a + 2*(da/2), v16, n/2);
+		for (size_t i = 0; i < n/2; ++i) {
+			host_memcpy(buf_ref + 2*(da/2) + 2*i, &v16, 2);
+		}
+		CHECK(host_memcmp(buf_a, buf_ref, BUF_SIZE) == 0);
+
+		const uint32_t v32 = rng.next();
+		memset32(buf_a + 4*(da/4), v32, n/4);
+		for (size_t i = 0; i < n/4; ++i) {
+			host_memcpy(buf_ref + 4*(da/4) + 4*i, &v32, 4);
+		}
+		CHECK(host_memcmp(buf_a, buf_ref, BUF_SIZE) == 0);
+
+		// mostly equal, with the odd difference
+		host_memcpy(buf_b + sa, buf_a + da, n);
+		if (n && rand_below(2)) buf_b[sa + rand_below(n)] ^= 1 << rand_below(8);
+		CHECK(sign(memcmp(buf_a + da, buf_b + sa, n)) == sign(host_memcmp(buf_a + da, buf_b + sa, n)));
+
+		const int needle = buf_a[da + rand_below(n+1)];
+		CHECK(memchr(buf_a + da, needle, n) == host_memchr(buf_a + da, needle, n));
+	}
+}
+
+void test_str() {
+	char *const a = (char*)buf_a;
+	char *const b = (char*)buf_b;
+
+	for (size_t trial = 0; trial < TRIALS; ++trial) {
+		const size_t len_a = rand_below(MAX_LEN);
+		const size_t len_b = rand_below(MAX_LEN);
+		char *const sa = a + rand_below(32);
+		char *const sb = b + rand_below(32);
+
+		fill_string(sa, len_a);
+		if (rand_below(2)) {
+			// b starts off as a copy of a
+			const size_t common = len_a < len_b ? len_a : len_b;
+			host_memcpy(sb, sa, common);
+			fill_string(sb + common, len_b - common);
+			if (common && rand_below(2)) sb[rand_below(common)] = 'z';
+		} else {
+			fill_string(sb, len_b);
+		}
+
+		CHECK(strlen(sa) == host_strlen(sa));
+		CHECK(sign(strcmp(sa, sb)) == sign(host_strcmp(sa, sb)));
+		const size_t n = rand_below(MAX_LEN + 16);
+		CHECK(sign(strncmp(sa, sb, n)) == sign(host_strncmp(sa, sb, n)));
+
+		const char c = "abcz"[rand_below(4)];
+		CHECK(strchr(sa, c) == host_strchr(sa, c));
+		CHECK(strchr(sa, 0) == host_strchr(sa, 0));
+	}
+}
+
+void test_string_functions() {
+	const bool had_sse2 = _string_internals::use_sse2;
+	const bool had_rep_movsb = _string_internals::use_rep_movsb;
+
+	_string_internals::use_sse2 = false;
+	_string_internals::use_rep_movsb = false;
+	test_mem();
+	test_str();
+
+	if (had_sse2) {
+		_string_internals::use_sse2 = true;
+		test_mem();
+		test_str();
+	}
+
+	// rep movsb always works, it just isn't always fast
+	_string_internals::use_rep_movsb = true;
+	test_mem();
+	_string_internals::use_rep_movsb = had_rep_movsb;
+}
+
+void test_snprintf() {
+	char buf[64];
+	char ref[64];
+
+	const char *const formats[] = {
+		"plain text", "%d", "%u", "%x", "%c", "%s", "100%%", "%d%s%u|%x",
+	};
+	const int32_t ints[] = { 0, 1, -1, 42, -42, 999999999, INT32_MAX, INT32_MIN };
+	const size_t sizes[] = { 64, 5, 1 };
+
+	for (const char *format : formats) {
+		for (const int32_t i : ints) {
+			const char *const str = i < 0 ? "negative" : "";
+			for (const size_t size : sizes) {
+				// there's always exactly as many arguments as
+				// specifiers (or more), so this is fine for each
+				const bool is_str = strcmp(format, "%s") == 0;
+				const int res = is_str
+					? snprintf(buf, size, format, str)
+					: snprintf(buf, size, format, i, str, i, i);
+				const int ref_res = is_str
+					? host_snprintf(ref, size, format, str)
+					: host_snprintf(ref, size, format, i, str, i, i);
+				CHECK(res == ref_res);
+				CHECK(strcmp(buf, ref) == 0);
+			}
+		}
+	}
+
+	// nothing written at all
+	CHECK(snprintf(nullptr, 0, "%d", 12345) == 5);
+
+	const int64_t longs[] = { 0, -1, 4294967296, INT64_MAX, INT64_MIN, 1234567890123 };
+	for (const int64_t l : longs) {
+		snprintf(buf, sizeof(buf), "%lld|%llu|%llx", (long long)l, (unsigned long long)l, (unsigned long long)l);
+		host_snprintf(ref, sizeof(ref), "%lld|%llu|%llx", (long long)l, (unsigned long long)l, (unsigned long long)l);
+		CHECK(strcmp(buf, ref) == 0);
+
+		snprintf(buf, sizeof(buf), "%ld|%lu", (long)l, (unsigned long)l);
+		host_snprintf(ref, sizeof(ref), "%ld|%lu", (long)l, (unsigned long)l);
+		CHECK(strcmp(buf, ref) == 0);
+	}
+
+	// values which are exact in binary, so that there's no question of
+	// how to round them
+	const double doubles[] = { 0.0, 1.0, -2.5, 0.375, 1234.0625, -1e15, 0.0009765625, 1.5, 0.5 };
+	for (const double d : doubles) {
+		snprintf(buf, sizeof(buf), "%f|%.0f|%.2f|%.10f", d, d, d, d);
+		host_snprintf(ref, sizeof(ref), "%f|%.0f|%.2f|%.10f", d, d, d, d);
+		CHECK(strcmp(buf, ref) == 0);
+	}
+}
+
+// a backend which collects everything, counting the writes
+char captured[256];
+size_t captured_len = 0;
+size_t capture_writes = 0;
+size_t capture(void *, const char *data, size_t len) {
+	host_memcpy(&captured[captured_len], data, len);
+	captured_len += len;
+	++capture_writes;
+	return len;
+}
+
+void test_streams() {
+	char buf[64];
+	FILE stream = { capture, nullptr, buf, 8, 0, _IOFBF, false };
+
+	// buffered until it fills up
+	CHECK(fputs("abc", &stream) == 0);
+	CHECK(fputc('d', &stream) == 'd');
+	CHECK(capture_writes == 0);
+	CHECK(fwrite("efghij", 2, 3, &stream) == 3);
+	CHECK(capture_writes == 1);
+	CHECK(fflush(&stream) == 0);
+	CHECK(captured_len == 10 && host_memcmp(captured, "abcdefghij", 10) == 0);
+
+	// printf output longer than the buffer still gets through, in order
+	captured_len = 0;
+	CHECK(fprintf(&stream, "%s=%d;", "a long name", -12345) == 19);
+	fflush(&stream);
+	CHECK(captured_len == 19 && host_memcmp(captured, "a long name=-12345;", 19) == 0);
+
+	// line buffered: flushed at the end of a line
+	setvbuf(&stream, nullptr, _IOLBF, 0);
+	captured_len = 0;
+	fprintf(&stream, "x=%d", 1);
+	CHECK(captured_len == 0);
+	fprintf(&stream, "\n");
+	CHECK(captured_len == 4);
+
+	// unbuffered: each printf is a single write
+	setvbuf(&stream, nullptr, _IONBF, 0);
+	capture_writes = 0;
+	fprintf(&stream, "%d %d %d", 1, 2, 3);
+	CHECK(capture_writes == 1);
+
+	// the ring log keeps the most recent output
+	const size_t size = _stdio_internals::RING_LOG_SIZE;
+	char *const log = (char*)host_malloc(size + 1);
+	for (size_t i = 0; i < size/10 + 5; ++i) fprintf(stdring, "%u\n", unsigned(100000000 + i));
+	CHECK(ring_log_read(log, size) == size);
+	// the last two lines are there in full
+	CHECK(host_memcmp(&log[size - 20], "100001641\n100001642\n", 20) == 0);
+	CHECK(ring_log_read(log, 5) == 5);
+	CHECK(host_memcmp(log, "1642\n", 5) == 0);
+	host_free(log);
+}
+
+void test_conv() {
+	char buf[DTOA_MAX + DTOA_FIXED_MAX_PRECISION + 1];
+	char ref[64];
+
+	const uint32_t edges32[] = { 0, 9, 10, 99, 100, 999999999, 1000000000, UINT32_MAX };
+	for (const uint32_t u : edges32) {
+		buf[utoa32(u, buf)] = 0;
+		host_snprintf(ref, sizeof(ref), "%u", u);
+		CHECK(strcmp(buf, ref) == 0);
+	}
+	for (size_t trial = 0; trial < TRIALS; ++trial) {
+		// all lengths equally often
+		const uint32_t u = rng.next() >> rand_below(32);
+		buf[utoa32(u, buf)] = 0;
+		host_snprintf(ref, sizeof(ref), "%u", u);
+		CHECK(strcmp(buf, ref) == 0);
+	}
+
+	const uint64_t edges64[] = {
+		uint64_t(UINT32_MAX) + 1, 9999999999999999ull, 10000000000000000ull,
+		99999999999999999ull, 100000000000000000ull, UINT64_MAX,
+	};
+	for (const uint64_t u : edges64) {
+		buf[utoa64(u, buf)] = 0;
+		host_snprintf(ref, sizeof(ref), "%llu", (unsigned long long)u);
+		CHECK(strcmp(buf, ref) == 0);
+	}
+	for (size_t trial = 0; trial < TRIALS; ++trial) {
+		const uint64_t u = ((uint64_t(rng.next()) << 32) | rng.next()) >> rand_below(64);
+		buf[utoa64(u, buf)] = 0;
+		host_snprintf(ref, sizeof(ref), "%llu", (unsigned long long)u);
+		CHECK(strcmp(buf, ref) == 0);
+	}
+
+	const struct { double d; const char *str; } exact[] = {
+		{ 0.0, "0" }, { -0.0, "-0" }, { 0.1, "0.1" }, { 1.0/3, "0.3333333333333333" },
+		{ 100.0, "100" }, { 1e21, "1e+21" }, { 123e18, "123000000000000000000" },
+		{ 1.5e-7, "1.5e-07" }, { 0.000015, "0.000015" }, { 5e-324, "5e-324" },
+		{ 1.7976931348623157e308, "1.7976931348623157e+308" },
+		{ 1.0/0.0, "inf" }, { -1.0/0.0, "-inf" }, { 0.0/0.0, "nan" },
+	};
+	for (const auto &e : exact) {
+		buf[dtoa(e.d, buf)] = 0;
+		CHECK(strcmp(buf, e.str) == 0);
+	}
+
+	// anything (finite) has to read back as exactly the same double
+	for (size_t trial = 0; trial < TRIALS; ++trial) {
+		const uint64_t bits = (uint64_t(rng.next()) << 32) | rng.next();
+		double d;
+		host_memcpy(&d, &bits, sizeof(d));
+		if (d != d || d - d != 0) continue;
+
+		const size_t len = dtoa(d, buf);
+		CHECK(len <= DTOA_MAX);
+		buf[len] = 0;
+		CHECK(host_strtod(buf, nullptr) == d);
+	}
+
+	buf[dtoa_fixed(2.5, 3, buf)] = 0;
+	CHECK(strcmp(buf, "2.500") == 0);
+	buf[dtoa_fixed(-0.996, 2, buf)] = 0;
+	CHECK(strcmp(buf, "-1.00") == 0);
+	buf[dtoa_fixed(1e300, 2, buf)] = 0;
+	CHECK(strcmp(buf, "1e+300") == 0);
+}
+
+void test_fmt() {
+	using sdk::fmt::format_to;
+
+	char buf[64];
+
+	CHECK(format_to(buf, SDK_FMT("{} of {}"), 3, 10u) == 7);
+	CHECK(strcmp(buf, "3 of 10") == 0);
+
+	format_to(buf, SDK_FMT("{}|{}|{}|{}"), "str", 'c', true, -2147483647-1);
+	CHECK(strcmp(buf, "str|c|true|-2147483648") == 0);
+
+	format_to(buf, SDK_FMT("{}|{}"), INT64_MIN, UINT64_MAX);
+	CHECK(strcmp(buf, "-9223372036854775808|18446744073709551615") == 0);
+
+	format_to(buf, SDK_FMT("[{:5}|{:<5}|{:05}|{:x}|{:08x}]"), 42, 42, -42, 255u, 0xbeefu);
+	CHECK(strcmp(buf, "[   42|42   |-0042|ff|0000beef]") == 0);
+
+	format_to(buf, SDK_FMT("{{{}}} {:.2}"), 1, "abcdef");
+	CHECK(strcmp(buf, "{1} ab") == 0);
+
+	format_to(buf, SDK_FMT("{}|{:.2}|{:.0}|{:8.3}|{}"), 3.14159265, 2.005, 0.5, -1.0, 0.0);
+	CHECK(strcmp(buf, "3.14159265|2.00|0|  -1.000|0") == 0 ||
+		strcmp(buf, "3.14159265|2.01|0|  -1.000|0") == 0);
+
+	format_to(buf, SDK_FMT("[{:08}|{:<6}|{}]"), -0.5, 0.1, 1e100);
+	CHECK(strcmp(buf, "[-00000.5|0.1   |1e+100]") == 0);
+
+	format_to(buf, SDK_FMT("{:.3}"), 0.9999);
+	CHECK(strcmp(buf, "1.000") == 0);
+
+	// truncated, but still null terminated and counting everything
+	char small[6];
+	CHECK(format_to(small, SDK_FMT("{}"), 1234567890) == 10);
+	CHECK(strcmp(small, "12345") == 0);
+
+	String str("x = ");
+	format_to(str, SDK_FMT("{}, {}"), 1, String("two"));
+	CHECK(strcmp(str.c_str(), "x = 1, two") == 0);
+}
+
+void test_malloc() {
+	constexpr size_t NUM_PTRS = 256;
+	uint8_t *ptrs[NUM_PTRS] = {};
+	size_t sizes[NUM_PTRS] = {};
+
+	const size_t bytes_before = _mm_internals::stats.live_bytes;
+
+	for (size_t trial = 0; trial < 4*TRIALS; ++trial) {
+		const size_t i = rand_below(NUM_PTRS);
+
+		// everything handed out still holds what was written to it
+		for (size_t j = 0; j < sizes[i]; ++j) {
+			if (ptrs[i][j] != uint8_t(i + j)) {
+				CHECK(ptrs[i][j] == uint8_t(i + j));
+				break;
+			}
+		}
+
+		// mostly small sizes, like the apps use, and some big ones
+		const size_t size = rand_below(8) ? rand_below(256) : rand_below(64*1024);
+		// how much of the old contents should still be there
+		size_t keep = 0;
+
+		switch (rand_below(3)) {
+			case 0:
+				free(ptrs[i]);
+				ptrs[i] = (uint8_t*)malloc(size);
+				break;
+			case 1:
+				free(ptrs[i]);
+				ptrs[i] = (uint8_t*)calloc(size, 1);
+				for (size_t j = 0; j < size; ++j) {
+					if (ptrs[i][j] != 0) {
+						CHECK(ptrs[i][j] == 0);
+						break;
+					}
+				}
+				break;
+			case 2:
+				keep = sizes[i] < size ? sizes[i] : size;
+				ptrs[i] = (uint8_t*)realloc(ptrs[i], size);
+				break;
+		}
+		sizes[i] = size;
+
+		CHECK(size == 0 || ptrs[i] != NULL);
+		if (ptrs[i] == NULL) {
+			sizes[i] = 0;
+			continue;
+		}
+		CHECK(malloc_usable_size(ptrs[i]) >= size);
+		CHECK((uintptr_t)ptrs[i] % 8 == 0);
+
+		for (size_t j = keep; j < size; ++j) {
+			ptrs[i][j] = i + j;
+		}
+		// realloc kept the start of the old contents
+		for (size_t j = 0; j < keep; ++j) {
+			if (ptrs[i][j] != uint8_t(i + j)) {
+				CHECK(ptrs[i][j] == uint8_t(i + j));
+				break;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < NUM_PTRS; ++i) {
+		free(ptrs[i]);
+	}
+
+	// nothing leaked
+	CHECK(_mm_internals::stats.live_bytes == bytes_before);
+}
+
+void test_list() {
+	List<int> list {};
+	for (int i = 0; i < 100; ++i) list.push_back(i);
+	CHECK(list.size() == 100);
+
+	list.insert(50, -1);
+	CHECK(list.size() == 101);
+	CHECK(list[49] == 49);
+	CHECK(list[50] == -1);
+	CHECK(list[51] == 50);
+
+	list.erase(list.begin() + 10, list.begin() + 20);
+	CHECK(list.size() == 91);
+	CHECK(list[9] == 9);
+	CHECK(list[10] == 20);
+	CHECK(list.back() == 99);
+
+	List<String> strings {};
+	for (int i = 0; i < 50; ++i) strings.push_back(String("line"));
+	strings.insert(25, String("middle"));
+	CHECK(strings.size() == 51);
+	CHECK(strcmp(strings[25].c_str(), "middle") == 0);
+	CHECK(strcmp(strings[26].c_str(), "line") == 0);
+}
+
+void test_string() {
+	String str("hello");
+	CHECK(str.size() == 5);
+
+	str += ", ";
+	str += String("world");
+	str += '!';
+	CHECK(strcmp(str.c_str(), "hello, world!") == 0);
+
+	str.erase(5, 7);
+	CHECK(strcmp(str.c_str(), "hello!") == 0);
+
+	str.insert(size_t(0), '>');
+	CHECK(strcmp(str.c_str(), ">hello!") == 0);
+
+	const String sub = str.substr(1, 6);
+	CHECK(strcmp(sub.c_str(), "hello") == 0);
+
+	// growing past the initial capacity, from a heap and an arena
+	sdk::Arena arena {};
+	String heap_str {};
+	String arena_str(4, &arena);
+	for (size_t i = 0; i < 1000; ++i) {
+		heap_str += char('a' + i%26);
+		arena_str += char('a' + i%26);
+	}
+	CHECK(heap_str.size() == 1000);
+	CHECK(strcmp(heap_str.c_str(), arena_str.c_str()) == 0);
+}
+
+void test_pool() {
+	struct Obj {
+		int a, b;
+		Obj(int a, int b) : a(a), b(b) { }
+	};
+
+	Pool<Obj, 8> pool {};
+	Obj *objs[20];
+	for (int i = 0; i < 20; ++i) objs[i] = pool.construct(i, -i);
+	CHECK(pool.live() == 20);
+	CHECK(pool.capacity() >= 20);
+	for (int i = 0; i < 20; ++i) CHECK(objs[i]->a == i && objs[i]->b == -i);
+
+	// freed cells get handed out again before the pool grows
+	const size_t capacity = pool.capacity();
+	pool.destroy(objs[3]);
+	Obj *again = pool.construct(1, 2);
+	CHECK(again == objs[3]);
+	CHECK(pool.capacity() == capacity);
+
+	Pool<Obj, 4> fixed(false);
+	for (int i = 0; i < 4; ++i) CHECK(fixed.construct(i, i) != nullptr);
+	CHECK(fixed.construct(0, 0) == nullptr);
+}
+
+void test_arena() {
+	sdk::Arena arena(1024);
+
+	void *first = arena.alloc(10);
+	CHECK((uintptr_t)first % sdk::Arena::DEFAULT_ALIGN == 0);
+	uint8_t *aligned = (uint8_t*)arena.alloc(3, 64);
+	CHECK((uintptr_t)aligned % 64 == 0);
+
+	const auto mark = arena.mark();
+	void *big = arena.alloc(4096);
+	CHECK(big != nullptr);
+	arena.reset(mark);
+	CHECK(arena.alloc(3, 64) == aligned + 64);
+
+	// resizing the latest allocation keeps it in place and its contents
+	char *grown = (char*)arena.alloc(16, 1);
+	host_memcpy(grown, "0123456789abcdef", 16);
+	char *resized = (char*)arena.resize(grown, 16, 32, 1);
+	CHECK(resized == grown);
+	CHECK(memcmp(resized, "0123456789abcdef", 16) == 0);
+}
+
+void test_arena_frames() {
+	// frames which all overflow the first chunk the same way shouldn't
+	// need more and more memory
+	sdk::Arena arena(16*1024);
+	arena.alloc(16);
+	const auto frame_start = arena.mark();
+
+	size_t peak_after_warmup = 0;
+	for (size_t frame = 0; frame < 64; ++frame) {
+		arena.alloc(12*1024);
+		arena.alloc(12*1024);
+		arena.reset(frame_start);
+
+		if (frame == 3) peak_after_warmup = _mm_internals::stats.peak_blocks;
+	}
+	CHECK(_mm_internals::stats.peak_blocks == peak_after_warmup);
+}
+
+void test_random() {
+	// the reference xorshift32, from the same (scrambled) seed
+	uint32_t state = 42 ^ 0xAAAAAAAA;
+	sdk::random::Xorshift32 prng(42);
+	for (size_t i = 0; i < 1000; ++i) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		CHECK(prng.next() == state);
+	}
+
+	sdk::random::seed(7);
+	const uint32_t first = sdk::random::random();
+	sdk::random::seed(7);
+	CHECK(sdk::random::random() == first);
+}
+
+struct Test {
+	const char *name;
+	void (*fn)();
+};
+const Test tests[] = {
+	{ "string.h", test_string_functions },
+	{ "snprintf", test_snprintf },
+	{ "utoa & dtoa", test_conv },
+	{ "stdio streams", test_streams },
+	{ "sdk::fmt", test_fmt },
+	{ "malloc & co.", test_malloc },
+	{ "sdk::util::List", test_list },
+	{ "sdk::util::String", test_string },
+	{ "sdk::util::Pool", test_pool },
+	{ "sdk::Arena", test_arena },
+	{ "sdk::Arena frames", test_arena_frames },
+	{ "sdk::random", test_random },
+};
+
+}
+
+size_t run_tests() {
+	size_t failed_tests = 0;
+
+	for (const auto &test : tests) {
+		const size_t failures_before = failures;
+		const size_t checks_before = checks;
+		test.fn();
+
+		const size_t test_failures = failures - failures_before;
+		printf("%-20s %s (%zu checks", test.name,
+			test_failures ? "FAIL" : "ok", checks - checks_before
+		);
+		if (test_failures) printf(", %zu failed", test_failures);
+		puts(")");
+
+		if (test_failures) ++failed_tests;
+	}
+
+	printf("%zu of %zu tests passed\n",
+		sizeof(tests)/sizeof(tests[0]) - failed_tests,
+		sizeof(tests)/sizeof(tests[0])
+	);
+
+	return failures;
+}
+
+}
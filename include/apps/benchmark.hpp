@@ -0,0 +1,7 @@
+#pragma once
+
+namespace benchmark {
+
+void main();
+
+}
@@ -45,7 +45,7 @@ public:
 		using namespace term;
 
 		cursor::disable();
-		auto _ = Backbuffer();
+		auto _ = Backbuffer(Backbuffer::Init::Clear);
 
 		/* Set up consistent starting state */
 		resetcolor();
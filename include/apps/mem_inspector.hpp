@@ -0,0 +1,7 @@
+#pragma once
+
+namespace mem_inspector {
+
+void main();
+
+}
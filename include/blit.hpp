@@ -12,8 +12,8 @@
 
 // turns a C++ char into a vga entry
 #define BLT_CHR(c) (0xC000 | uint16_t(c))
-// writes a character to the given index in the VGA buffer
-#define BLT_PUT_CHR(ix, c) ((uint16_t*)vga::ADDR)[ix] = BLT_CHR(c)
+// writes a character to the given index on the screen
+#define BLT_PUT_CHR(ix, c) term::screen()[ix] = BLT_CHR(c)
 // writes a string s of length l into the VGA buffer starting at index ix
 #define BLT_PUT_STR(ix, s, l) do { \
 		for (size_t _blt_str_idx = 0; _blt_str_idx < l; ++_blt_str_idx) { \
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+// the x87 FPU and SSE are set up in boot.s, before any C++ code runs.
+// IRQ handlers may use them too: the interrupted code's FPU state is
+// saved the first time they do (see isr.s)
+
+namespace fpu {
+
+// CPUID leaf 1 feature flags (edx)
+constexpr uint32_t FEATURE_FPU  = 1 << 0;
+constexpr uint32_t FEATURE_FXSR = 1 << 24;
+constexpr uint32_t FEATURE_SSE  = 1 << 25;
+constexpr uint32_t FEATURE_SSE2 = 1 << 26;
+
+// as read in boot.s
+extern "C" uint32_t fpu_cpu_features;
+
+inline bool has(uint32_t features) {
+	return (fpu_cpu_features & features) == features;
+}
+
+}
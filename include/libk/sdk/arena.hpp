@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace sdk {
+
+// bump allocator for short-lived memory: allocating just moves a pointer
+// forward, and nothing is freed individually; instead everything
+// allocated since a mark is thrown away at once by resetting to it.
+// Memory is taken from the heap in chunks, and more chunks are added
+// when one runs out, so allocations never fail
+class Arena {
+	struct Chunk {
+		Chunk *prev;
+		size_t size;
+
+		uint8_t *data() { return (uint8_t*)(this+1); }
+	};
+
+	Chunk *curr = nullptr;
+	// how much of the current chunk is in use
+	size_t top = 0;
+	// how big each chunk is, unless an allocation needs a bigger one
+	size_t chunk_size;
+
+	void add_chunk(size_t min_size);
+public:
+	static constexpr size_t DEFAULT_ALIGN = alignof(max_align_t);
+
+	struct Mark {
+		Chunk *chunk;
+		size_t top;
+	};
+
+	// no memory is taken from the heap until the first allocation
+	Arena(size_t chunk_size = 16*1024);
+	~Arena();
+
+	Arena(const Arena&) = delete;
+	Arena &operator=(const Arena&) = delete;
+
+	// the memory isn't cleared
+	void *alloc(size_t size, size_t align = DEFAULT_ALIGN);
+	// grows (or shrinks) the allocation in place if it's the most recent
+	// one and there's space, otherwise it gets copied to a new allocation
+	void *resize(void *p, size_t old_size, size_t new_size, size_t align = DEFAULT_ALIGN);
+
+	Mark mark() const { return { curr, top }; }
+	// throw away everything allocated since the mark was made
+	void reset(Mark mark);
+	// throw away everything
+	void reset() { reset({ nullptr, 0 }); }
+};
+
+}
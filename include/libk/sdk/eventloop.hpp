@@ -3,6 +3,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <sdk/arena.hpp>
+
 #include "ps2.hpp"
 
 namespace sdk {
@@ -12,6 +14,10 @@ class Frame;
 class EventLoop {
 private:
 	friend Frame;
+	// backs each frame's scratch memory, kept between frames so that
+	// its memory can be reused
+	Arena scratch_arena;
+
 	virtual void frame_startup() = 0;
 	virtual void frame_teardown() = 0;
 public:
@@ -22,10 +28,17 @@ public:
 class Frame {
 	EventLoop &owner;
 	uint32_t frame_end;
+	Arena::Mark scratch_mark;
 public:
 	Frame(EventLoop &owner, uint32_t frame_length);
 	~Frame();
 
+	// memory for temporaries which only need to last until the end of
+	// the frame; it's all thrown away when the frame is over. (None of
+	// the apps need it yet: the menu, the pager and pi draw straight to
+	// the terminal, without allocating anything per frame)
+	Arena &scratch() { return owner.scratch_arena; }
+
 	Frame(const Frame&) = delete;
 	Frame &operator=(const Frame&) = delete;
 	Frame(Frame&&) = default;
@@ -0,0 +1,395 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sdk/util.hpp>
+
+// type-safe formatting without any allocation, eg.
+//
+//   char buf[32];
+//   sdk::fmt::format_to(buf, SDK_FMT("{} of {}"), done, total);
+//   sdk::fmt::print(SDK_FMT("{:02}:{:02}\n"), minutes, seconds);
+//
+// Each `{}` is replaced by the next argument. Inside the braces, after a
+// colon, can come (in this order, all optional):
+//  - `<` to left align the argument (it's right aligned otherwise)
+//  - `0` to pad numbers with zeroes instead of spaces
+//  - a minimum width
+//  - `.` and a precision: digits after the decimal point for doubles
+//    (which otherwise get the shortest digits that read back as the same
+//    value), or the most characters to take from a string
+//  - `x` to write an integer in hex
+// `{{` and `}}` give a literal brace.
+//
+// The format string has to be wrapped in SDK_FMT, so that it can be
+// parsed at compile time: a malformed format string, the wrong number of
+// arguments or a spec that doesn't fit an argument's type is a compile
+// error, and nothing is left to parse at runtime.
+//
+// Other types can be formatted by specialising sdk::fmt::Formatter, see
+// the ones at the bottom of this file.
+
+#define SDK_FMT(str) ([] { \
+		struct _sdk_fmt_string { \
+			static constexpr const char *value() { return str; } \
+		}; \
+		return ::sdk::fmt::FormatString<_sdk_fmt_string>{}; \
+	}())
+
+namespace sdk::fmt {
+
+// what SDK_FMT gives, with the string itself in Str::value()
+template<typename Str>
+struct FormatString { };
+
+// where formatted output goes
+class Writer {
+public:
+	virtual void write(const char *data, size_t len) = 0;
+
+	// write c count times
+	void fill(char c, size_t count);
+};
+
+// writes into a fixed buffer, always null terminated, dropping whatever
+// doesn't fit
+class BufferWriter : public Writer {
+	char *buf;
+	size_t size;
+	size_t len = 0;
+	size_t wanted = 0;
+public:
+	BufferWriter(char *buf, size_t size);
+
+	void write(const char *data, size_t len) override;
+
+	// what's been written into the buffer
+	size_t written() const { return len; }
+	// how long the output would have been if the buffer was big enough
+	size_t total() const { return wanted; }
+};
+
+// appends to a String
+class StringWriter : public Writer {
+	util::String &str;
+public:
+	StringWriter(util::String &str) : str(str) { }
+
+	void write(const char *data, size_t len) override;
+};
+
+// collects output and writes it to the terminal all at once, when the
+// buffer fills up or the writer is destroyed
+class TerminalWriter : public Writer {
+	char buf[128];
+	size_t len = 0;
+public:
+	TerminalWriter() = default;
+	~TerminalWriter();
+
+	TerminalWriter(const TerminalWriter&) = delete;
+	TerminalWriter &operator=(const TerminalWriter&) = delete;
+
+	void write(const char *data, size_t len) override;
+	void flush();
+};
+
+struct Spec {
+	bool left = false;
+	bool zero_pad = false;
+	bool hex = false;
+	uint8_t width = 0;
+	// -1 if not given
+	int8_t precision = -1;
+};
+
+// formatters for the basic types, which the Formatter specialisations
+// below hand over to
+void write_str(Writer &out, const char *str, size_t len, const Spec &spec);
+void write_int(Writer &out, uint64_t magnitude, bool negative, const Spec &spec);
+void write_double(Writer &out, double d, const Spec &spec);
+void write_pointer(Writer &out, const void *p, const Spec &spec);
+
+// a type can be formatted if there's a specialisation with:
+//   static constexpr bool accepts(const Spec &spec);
+//   static void write(Writer &out, const T &value, const Spec &spec);
+template<typename T>
+struct Formatter;
+
+namespace detail {
+
+constexpr size_t PARSE_ERROR = ~size_t(0);
+
+// a piece of the format string: either literal text, or an argument
+struct Segment {
+	const char *text = nullptr;
+	size_t len = 0;
+	bool is_arg = false;
+	Spec spec {};
+};
+
+constexpr bool is_digit(char c) {
+	return '0' <= c && c <= '9';
+}
+
+// parses the spec after the opening brace, leaving p after the closing one
+constexpr bool parse_spec(const char *&p, Spec &spec) {
+	if (*p == ':') {
+		++p;
+		if (*p == '<') {
+			spec.left = true;
+			++p;
+		}
+		if (*p == '0') {
+			spec.zero_pad = true;
+			++p;
+		}
+		size_t width = 0;
+		while (is_digit(*p)) {
+			width = width*10 + (*p++ - '0');
+			if (width > 255) return false;
+		}
+		spec.width = width;
+		if (*p == '.') {
+			++p;
+			if (!is_digit(*p)) return false;
+			size_t precision = 0;
+			while (is_digit(*p)) {
+				precision = precision*10 + (*p++ - '0');
+				if (precision > 127) return false;
+			}
+			spec.precision = precision;
+		}
+		if (*p == 'x') {
+			spec.hex = true;
+			++p;
+		}
+	}
+	if (*p != '}') return false;
+	++p;
+	return true;
+}
+
+// splits str into segments, writing them into out if it isn't null;
+// returns how many there are, or PARSE_ERROR
+constexpr size_t parse(const char *str, Segment *out) {
+	size_t count = 0;
+	const char *p = str;
+
+	while (*p) {
+		Segment seg {};
+
+		if (*p == '{' && p[1] != '{') {
+			++p;
+			seg.is_arg = true;
+			if (!parse_spec(p, seg.spec)) return PARSE_ERROR;
+		} else if (*p == '}' && p[1] != '}') {
+			return PARSE_ERROR;
+		} else if (*p == '{' || *p == '}') {
+			// an escaped brace, which is kept as literal text
+			seg.text = p;
+			seg.len = 1;
+			p += 2;
+		} else {
+			seg.text = p;
+			while (*p && *p != '{' && *p != '}') ++p;
+			seg.len = p - seg.text;
+		}
+
+		if (out) out[count] = seg;
+		++count;
+	}
+
+	return count;
+}
+
+template<size_t N>
+struct Segments {
+	Segment items[N ? N : 1];
+};
+
+template<typename Str>
+struct Parsed {
+	static constexpr size_t parsed_size = parse(Str::value(), nullptr);
+	static_assert(parsed_size != PARSE_ERROR, "invalid format string");
+	static constexpr size_t size = parsed_size == PARSE_ERROR ? 0 : parsed_size;
+
+	static constexpr Segments<size> make() {
+		Segments<size> res {};
+		parse(Str::value(), res.items);
+		return res;
+	}
+	static constexpr Segments<size> segments = make();
+
+	static constexpr size_t count_args() {
+		size_t res = 0;
+		for (size_t i = 0; i < size; ++i) res += segments.items[i].is_arg;
+		return res;
+	}
+	static constexpr size_t num_args = count_args();
+
+	static constexpr Spec arg_spec(size_t arg) {
+		for (size_t i = 0; i < size; ++i) {
+			if (!segments.items[i].is_arg) continue;
+			if (arg-- == 0) return segments.items[i].spec;
+		}
+		return Spec {};
+	}
+};
+
+// string literals and char arrays are formatted as strings
+template<typename T> struct Decay { using type = T; };
+template<typename T> struct Decay<const T> { using type = typename Decay<T>::type; };
+template<size_t N> struct Decay<char[N]> { using type = const char *; };
+template<> struct Decay<char*> { using type = const char *; };
+
+template<typename Str, size_t I, typename... Args>
+struct CheckSpecs {
+	static constexpr bool ok() { return true; }
+};
+template<typename Str, size_t I, typename T, typename... Rest>
+struct CheckSpecs<Str, I, T, Rest...> {
+	static constexpr bool ok() {
+		return Formatter<typename Decay<T>::type>::accepts(Parsed<Str>::arg_spec(I))
+			&& CheckSpecs<Str, I+1, Rest...>::ok();
+	}
+};
+
+// a type-erased argument
+struct Arg {
+	const void *value;
+	void (*write)(Writer &out, const void *value, const Spec &spec);
+};
+
+template<typename T>
+struct ArgWriter {
+	static void write(Writer &out, const void *value, const Spec &spec) {
+		Formatter<typename Decay<T>::type>::write(out, *(const T*)value, spec);
+	}
+};
+template<size_t N>
+struct ArgWriter<char[N]> {
+	static void write(Writer &out, const void *value, const Spec &spec) {
+		write_str(out, (const char*)value, strlen((const char*)value), spec);
+	}
+};
+
+void vformat(Writer &out, const Segment *segments, size_t num_segments, const Arg *args);
+
+}
+
+template<typename Str, typename... Args>
+void format_to(Writer &out, FormatString<Str>, const Args &...args) {
+	using Parsed = detail::Parsed<Str>;
+	static_assert(Parsed::num_args == sizeof...(Args),
+		"the number of arguments doesn't match the format string"
+	);
+	static_assert(detail::CheckSpecs<Str, 0, Args...>::ok(),
+		"a format spec doesn't fit its argument's type"
+	);
+
+	const detail::Arg erased[sizeof...(Args) ? sizeof...(Args) : 1] = {
+		{ &args, detail::ArgWriter<Args>::write }...
+	};
+	detail::vformat(out, Parsed::segments.items, Parsed::size, erased);
+}
+
+// returns the length of the output, without the null terminator (as much
+// of it as fits is written into buf)
+template<typename Str, typename... Args>
+size_t format_to(char *buf, size_t size, FormatString<Str> str, const Args &...args) {
+	BufferWriter out(buf, size);
+	format_to(out, str, args...);
+	return out.total();
+}
+template<size_t N, typename Str, typename... Args>
+size_t format_to(char (&buf)[N], FormatString<Str> str, const Args &...args) {
+	return format_to(buf, N, str, args...);
+}
+
+// appends to the string
+template<typename Str, typename... Args>
+void format_to(util::String &str, FormatString<Str> format, const Args &...args) {
+	StringWriter out(str);
+	format_to(out, format, args...);
+}
+
+// writes to the terminal at the cursor, in one go
+template<typename Str, typename... Args>
+void print(FormatString<Str> str, const Args &...args) {
+	TerminalWriter out;
+	format_to(out, str, args...);
+}
+
+template<>
+struct Formatter<const char*> {
+	static constexpr bool accepts(const Spec &spec) { return !spec.hex && !spec.zero_pad; }
+	static void write(Writer &out, const char *value, const Spec &spec);
+};
+template<>
+struct Formatter<util::String> {
+	static constexpr bool accepts(const Spec &spec) { return !spec.hex && !spec.zero_pad; }
+	static void write(Writer &out, const util::String &value, const Spec &spec) {
+		write_str(out, value.c_str(), value.size(), spec);
+	}
+};
+template<>
+struct Formatter<char> {
+	static constexpr bool accepts(const Spec &spec) { return !spec.hex && !spec.zero_pad && spec.precision < 0; }
+	static void write(Writer &out, char value, const Spec &spec) {
+		write_str(out, &value, 1, spec);
+	}
+};
+template<>
+struct Formatter<bool> {
+	static constexpr bool accepts(const Spec &spec) { return !spec.hex && !spec.zero_pad && spec.precision < 0; }
+	static void write(Writer &out, bool value, const Spec &spec) {
+		if (value) write_str(out, "true", 4, spec);
+		else write_str(out, "false", 5, spec);
+	}
+};
+
+template<typename T>
+struct IntFormatter {
+	static constexpr bool accepts(const Spec &spec) { return spec.precision < 0; }
+	static void write(Writer &out, T value, const Spec &spec) {
+		if (T(-1) < T(0) && value < 0) {
+			// also works for the most negative value, which has no
+			// positive counterpart
+			write_int(out, ~uint64_t(value) + 1, true, spec);
+		} else {
+			write_int(out, uint64_t(value), false, spec);
+		}
+	}
+};
+template<> struct Formatter<signed char> : IntFormatter<signed char> { };
+template<> struct Formatter<unsigned char> : IntFormatter<unsigned char> { };
+template<> struct Formatter<short> : IntFormatter<short> { };
+template<> struct Formatter<unsigned short> : IntFormatter<unsigned short> { };
+template<> struct Formatter<int> : IntFormatter<int> { };
+template<> struct Formatter<unsigned int> : IntFormatter<unsigned int> { };
+template<> struct Formatter<long> : IntFormatter<long> { };
+template<> struct Formatter<unsigned long> : IntFormatter<unsigned long> { };
+template<> struct Formatter<long long> : IntFormatter<long long> { };
+template<> struct Formatter<unsigned long long> : IntFormatter<unsigned long long> { };
+
+template<>
+struct Formatter<double> {
+	static constexpr bool accepts(const Spec &spec) { return !spec.hex; }
+	static void write(Writer &out, double value, const Spec &spec) {
+		write_double(out, value, spec);
+	}
+};
+template<>
+struct Formatter<float> : Formatter<double> { };
+
+template<typename T>
+struct Formatter<T*> {
+	static constexpr bool accepts(const Spec &spec) { return !spec.hex && spec.precision < 0; }
+	static void write(Writer &out, const T *value, const Spec &spec) {
+		write_pointer(out, value, spec);
+	}
+};
+
+}
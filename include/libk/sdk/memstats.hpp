@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// heap statistics, to see how much memory is in use and who's using it
+
+namespace sdk::memstats {
+
+struct Stats {
+	// all in bytes
+	size_t total;
+	size_t live;
+	size_t peak;
+	// memory taken up by live allocations, including the rounding up
+	// to blocks and slab pages; the difference with `live` is overhead
+	size_t live_in_blocks;
+	size_t peak_in_blocks;
+	size_t free;
+	size_t largest_free_run;
+
+	size_t allocs;
+	size_t frees;
+	size_t reallocs_in_place;
+	size_t reallocs_copied;
+	// calloc'd bytes which didn't have to be cleared
+	size_t zeroing_skipped;
+
+	// how chopped up the free memory is, in percent:
+	// 0 if it's all in one run, approaching 100 as it gets split
+	// into ever smaller pieces
+	uint32_t fragmentation;
+};
+Stats get();
+
+// allocations by requested size, in power of two buckets
+size_t num_buckets();
+// the largest size counted in the bucket (the last bucket counts
+// everything larger as well)
+size_t bucket_limit(size_t bucket);
+size_t bucket_allocs(size_t bucket);
+
+// allocation sites; only recorded if the kernel was built with
+// MM_TRACE_CALLERS=1, otherwise there are never any callers
+struct Caller {
+	// return address of the malloc/calloc/realloc call
+	void *addr;
+	size_t allocs;
+	// total requested, not what's currently live
+	size_t bytes;
+};
+bool tracing_callers();
+// writes the (up to) max callers which allocated the most bytes to out,
+// heaviest first, and returns how many there were
+size_t top_callers(Caller *out, size_t max);
+
+// print everything above to the terminal
+void print();
+
+}
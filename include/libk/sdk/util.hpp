@@ -7,6 +7,7 @@
 #include <string.h>
 
 #include <cppsupport.hpp>
+#include <sdk/arena.hpp>
 
 namespace sdk::util {
 
@@ -24,6 +25,10 @@ template<typename T>
 typename RemoveReference<T>::type&& move(T&& arg) noexcept {
 	return static_cast<typename RemoveReference<T>::type&&>(arg);
 }
+template<typename T>
+T&& forward(typename RemoveReference<T>::type &arg) noexcept {
+	return static_cast<T&&>(arg);
+}
 
 template<typename T>
 struct Maybe {
@@ -75,27 +80,57 @@ class List {
 	alignas(T*) memory_cell_t *buf;
 	size_t len;
 	size_t cap;
+	// where the buffer comes from: the heap, unless an arena is given
+	Arena *arena;
+
+	static memory_cell_t *alloc_buf(size_t capacity, Arena *arena) {
+		if (arena) {
+			return (memory_cell_t*)arena->alloc(capacity*sizeof(T), alignof(T));
+		}
+		return (memory_cell_t*)calloc(capacity, sizeof(T));
+	}
+	void free_buf() {
+		// arena memory is only given back when the arena is reset
+		if (!arena) free(buf);
+	}
 
 	void grow_cap() {
+		if (arena) {
+			const size_t new_cap = cap ? cap*2 : 64;
+			buf = (memory_cell_t*)arena->resize(
+				buf, cap*sizeof(T), new_cap*sizeof(T), alignof(T)
+			);
+			cap = new_cap;
+			return;
+		}
+
+		// the allocator often hands out more than was asked for,
+		// so use that up before asking for more
+		const size_t usable = malloc_usable_size(buf) / sizeof(T);
+		if (usable > cap) {
+			cap = usable;
+			return;
+		}
+
 		cap *= 2;
 		if (cap == 0) cap = 64;
-		buf = (memory_cell_t*)realloc(buf, cap);
+		buf = (memory_cell_t*)reallocarray(buf, cap, sizeof(T));
 		assert(buf != NULL);
 	}
 public:
 	using iterator = T*;
 	using const_iterator = const T*;
 
-	List(size_t capacity = 64)
-	: len(0), cap(capacity) {
-		buf = (memory_cell_t*)calloc(capacity, sizeof(T));
+	List(size_t capacity = 64, Arena *arena = nullptr)
+	: len(0), cap(capacity), arena(arena) {
+		buf = alloc_buf(capacity, arena);
 		assert(buf != NULL);
 		assert(cap != 0);
 	}
 	template<size_t N>
 	List(const T (&array)[N])
-	: len(N), cap(N) {
-		buf = (memory_cell_t*)calloc(cap, sizeof(T));
+	: len(N), cap(N), arena(nullptr) {
+		buf = alloc_buf(cap, arena);
 
 		assert(buf != NULL);
 		assert(len != 0);
@@ -110,7 +145,7 @@ public:
 			for (auto &elem : *this) {
 				elem.~T();
 			}
-			free(buf);
+			free_buf();
 		}
 	}
 
@@ -132,6 +167,7 @@ public:
 		this->buf = other.buf;
 		this->len = other.len;
 		this->cap = other.cap;
+		this->arena = other.arena;
 		other.buf = nullptr;
 		other.len = 0;
 		other.cap = 0;
@@ -141,11 +177,12 @@ public:
 			for (auto &elem : *this) {
 				elem.~T();
 			}
-			free(this->buf);
+			free_buf();
 		}
 		this->buf = other.buf;
 		this->len = other.len;
 		this->cap = other.cap;
+		this->arena = other.arena;
 		other.buf = nullptr;
 		other.len = 0;
 		other.cap = 0;
@@ -164,6 +201,7 @@ public:
 
 	size_t size() const { return len; }
 	size_t capacity() const { return cap; }
+	Arena *get_arena() const { return arena; }
 
 	void insert(size_t before, const T &val) {
 		assert(before <= len);
@@ -192,7 +230,7 @@ public:
 		assert(before <= len);
 
 		if (before == len) {
-			this->push_back(val);
+			this->push_back(move(val));
 		} else {
 			if (len == cap) {
 				grow_cap();
@@ -203,13 +241,13 @@ public:
 				new ((void*)&buf[i+1]) T(move(*(T*)&buf[i]));
 			}
 
-			new ((void*)&buf[before]) T(val);
+			new ((void*)&buf[before]) T(move(val));
 
 			++len;
 		}
 	}
 	void insert(iterator before, T &&val) {
-		this->insert(before - begin(), val);
+		this->insert(before - begin(), move(val));
 	}
 
 	void push_back(const T &val) {
@@ -222,7 +260,7 @@ public:
 		if (len == cap) {
 			grow_cap();
 		}
-		new ((void*)&buf[len++]) T(val);
+		new ((void*)&buf[len++]) T(move(val));
 	}
 	T &&pop_back() {
 		return move(*(T*)&buf[--len]);
@@ -269,11 +307,117 @@ public:
 	}
 };
 
+// keeps objects of a single type in slabs of N at a time, handing out
+// free cells from an intrusive free list, so that constructing and
+// destroying objects is O(1) and they don't each need their own block.
+// Objects never move, so pointers to them stay valid until destroyed
+template<typename T, size_t N = 64>
+class Pool {
+	union Cell {
+		Cell *next;
+		alignas(T) uint8_t storage[sizeof(T)];
+	};
+	struct Slab {
+		Slab *next;
+		Cell cells[N];
+	};
+
+	Slab *slabs = nullptr;
+	Cell *free_list = nullptr;
+	// whether more slabs get added once the first one is full
+	bool can_grow;
+
+	size_t num_slabs = 0;
+	size_t num_live = 0;
+#ifdef SDK_POOL_STATS
+	size_t num_peak = 0;
+	size_t num_constructed = 0;
+#endif
+
+	void add_slab() {
+		Slab *slab = (Slab*)malloc(sizeof(Slab));
+		assert(slab != NULL);
+		slab->next = slabs;
+		slabs = slab;
+		++num_slabs;
+
+		// thread the free list through the new cells, in order
+		for (size_t i = 0; i < N-1; ++i) {
+			slab->cells[i].next = &slab->cells[i+1];
+		}
+		slab->cells[N-1].next = free_list;
+		free_list = &slab->cells[0];
+	}
+public:
+	static_assert(N > 0, "a pool's slabs need room for at least one object");
+
+	Pool(bool can_grow = true) : can_grow(can_grow) {
+		add_slab();
+	}
+	// objects still in the pool aren't destroyed, only their memory is
+	// freed, so they should be destroyed first
+	~Pool() {
+		while (slabs) {
+			Slab *next = slabs->next;
+			free(slabs);
+			slabs = next;
+		}
+	}
+
+	Pool(const Pool&) = delete;
+	Pool &operator=(const Pool&) = delete;
+
+	// returns nullptr if the pool is full and isn't allowed to grow
+	template<typename... Args>
+	T *construct(Args&&... args) {
+		if (free_list == nullptr) {
+			if (!can_grow) return nullptr;
+			add_slab();
+		}
+
+		Cell *cell = free_list;
+		free_list = cell->next;
+
+		++num_live;
+#ifdef SDK_POOL_STATS
+		++num_constructed;
+		if (num_live > num_peak) num_peak = num_live;
+#endif
+
+		return new ((void*)cell->storage) T(forward<Args>(args)...);
+	}
+	void destroy(T *p) {
+		if (p == nullptr) return;
+		assert(num_live > 0);
+
+		p->~T();
+
+		Cell *cell = (Cell*)p;
+		cell->next = free_list;
+		free_list = cell;
+
+		--num_live;
+	}
+
+	size_t live() const { return num_live; }
+	size_t capacity() const { return num_slabs*N; }
+#ifdef SDK_POOL_STATS
+	// only counted when built with POOL_STATS=1, since every construct
+	// would pay for them otherwise
+	size_t peak() const { return num_peak; }
+	size_t constructed() const { return num_constructed; }
+#endif
+};
+
 class String {
 	char *buf;
 	size_t len;
 	size_t cap;
+	// where the buffer comes from: the heap, unless an arena is given
+	Arena *arena;
 
+	static char *alloc_buf(size_t capacity, Arena *arena);
+	void free_buf();
 	void grow_cap();
 	void add_char_unsafe(char c);
 	void add_null_terminator();
@@ -281,27 +425,32 @@ public:
 	using iterator = char *;
 	using const_iterator = const char *;
 
-	String(size_t capacity = 64)
-	: len(0), cap(capacity) {
-		buf = (char*)calloc(capacity, sizeof(char));
+	String(size_t capacity = 64, Arena *arena = nullptr)
+	: len(0), cap(capacity), arena(arena) {
+		buf = alloc_buf(capacity, arena);
 		assert(buf != NULL);
 		assert(cap != 0);
 	}
-	String(const char *str) : String(str, strlen(str)) { }
-	String(const char *str, size_t len) : String(len+1) {
+	String(const char *str, Arena *arena = nullptr)
+	: String(str, strlen(str), arena) { }
+	String(const char *str, size_t len, Arena *arena = nullptr)
+	: String(len+1, arena) {
 		this->len = len;
 
-		// no need for explicit null terminator,
-		// buffer is calloc'd so zeroed by default
 		for (size_t i = 0; i < len; ++i) {
 			buf[i] = str[i];
 		}
+		// heap buffers are calloc'd, but arena memory isn't cleared
+		buf[len] = 0;
 	}
 	~String() {
-		if (buf) free(buf);
+		if (buf) free_buf();
 	}
 
-	String(const String &str) : String(str.buf, str.len) { }
+	// copies go on the heap unless they're given an arena, so that a
+	// copy of a temporary can outlive it
+	String(const String &str, Arena *arena = nullptr)
+	: String(str.buf, str.len, arena) { }
 	String &operator=(const String &str) {
 		this->len = 0;
 		return *this += str;
@@ -310,15 +459,17 @@ public:
 		this->buf = str.buf;
 		this->len = str.len;
 		this->cap = str.cap;
+		this->arena = str.arena;
 		str.buf = nullptr;
 		str.len = 0;
 		str.cap = 0;
 	}
 	String &operator=(String &&str) {
-		if (this->buf) free(this->buf);
+		if (this->buf) free_buf();
 		this->buf = str.buf;
 		this->len = str.len;
 		this->cap = str.cap;
+		this->arena = str.arena;
 		str.buf = nullptr;
 		str.len = 0;
 		str.cap = 0;
@@ -331,6 +482,7 @@ public:
 
 	size_t size() const { return len; }
 	size_t capacity() const { return cap; }
+	Arena *get_arena() const { return arena; }
 
 	// erase at index, min(count, size() - index) characters
 	void erase(size_t index = 0, size_t count = ~static_cast<size_t>(0));
@@ -358,6 +510,7 @@ public:
 
 	const char *c_str() const { return buf; }
 
+	String &append(const char *str, size_t len);
 	String &operator+=(char c);
 	String &operator+=(const char *str);
 	String &operator+=(const String &other);
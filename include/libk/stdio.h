@@ -2,12 +2,110 @@
 
 #include <sys/cdefs.h>
 
+#include <stdarg.h>
+#include <stddef.h>
+
 #define EOF (-1)
 
+struct FILE;
+
+namespace _stdio_internals {
+	// where formatted output goes: characters are collected in buf, which
+	// is handed to flush whenever it fills up (eg. to write it to the
+	// terminal all at once). Without a flush function, whatever doesn't
+	// fit is dropped, like snprintf does
+	struct sink_t {
+		char *buf;
+		size_t size;
+		size_t len;
+		// everything put so far, including anything dropped
+		size_t total;
+		void (*flush)(void *ctx, const char *data, size_t len);
+		void *ctx;
+	};
+
+	void put(sink_t &sink, const char *data, size_t len);
+	void put(sink_t &sink, char c);
+	// hands whatever is in the buffer to the sink's flush function
+	void flush(sink_t &sink);
+
+	// the printf family's formatting, returns the number of characters
+	// put (or -1 if that doesn't fit in an int)
+	int format(sink_t &sink, const char *__restrict format, va_list args);
+
+	// hands data straight to the stream's backend, past its buffer
+	void write_direct(FILE *stream, const char *data, size_t len);
+	// writes through the stream's buffer, as its mode says
+	void write(FILE *stream, const char *data, size_t len);
+	// hands whatever is in the stream's buffer to its backend
+	void flush(FILE *stream);
+	// flushes a line buffered stream if there's a newline in its buffer
+	void flush_lines(FILE *stream);
+
+	// how much printf formats on the stack before writing it out, for
+	// streams without a buffer of their own
+	static constexpr size_t PRINTF_BUF_SIZE = 256;
+
+	// the in-memory ring log behind stdring: the last RING_LOG_SIZE
+	// bytes written to it, with ring_log_total counting everything ever
+	// written (so the oldest byte kept is at ring_log_total % RING_LOG_SIZE
+	// once it has wrapped around)
+	static constexpr size_t RING_LOG_SIZE = 16*1024;
+	extern char ring_log[RING_LOG_SIZE];
+	extern size_t ring_log_total;
+}
+
+#define _IOFBF 0 /* flushed when the buffer fills up */
+#define _IOLBF 1 /* and at the end of any write containing a newline */
+#define _IONBF 2 /* every write goes straight to the backend */
+
+// an output stream: a backend's write function, and optionally a buffer
+// for collecting output before handing it over.
+// New backends can be made by filling one in, eg.
+//   FILE my_stream = { my_write, my_ctx, buf, sizeof(buf), 0, _IOFBF, false };
+struct FILE {
+	// hands len bytes to the backend, returns how many it took
+	size_t (*write)(void *ctx, const char *data, size_t len);
+	void *ctx;
+
+	char *buf;
+	size_t size;
+	size_t len;
+	int mode;
+
+	// set when the backend didn't take everything
+	bool error;
+};
+
+// the terminal (unbuffered, but each printf call still reaches the
+// terminal in a single write)
+extern FILE *stdout;
+extern FILE *stderr;
+// non-standard: COM1 (line buffered), and the in-memory ring log (see
+// _stdio_internals, read back with ring_log_read). Both are much cheaper
+// than the terminal, which has to write to VGA memory and move the cursor
+extern FILE *stdserial;
+extern FILE *stdring;
+
 extern "C" {
 
 int printf(const char *__restrict, ...);
+int vprintf(const char *__restrict, va_list);
+int fprintf(FILE *__restrict, const char *__restrict, ...);
+int vfprintf(FILE *__restrict, const char *__restrict, va_list);
+int snprintf(char *__restrict, size_t, const char *__restrict, ...);
+int vsnprintf(char *__restrict, size_t, const char *__restrict, va_list);
 int putchar(int);
 int puts(const char *);
+int fputc(int, FILE *);
+int fputs(const char *__restrict, FILE *__restrict);
+size_t fwrite(const void *__restrict, size_t, size_t, FILE *__restrict);
+int fflush(FILE *);
+// a null buf only changes the mode, keeping the current buffer
+int setvbuf(FILE *__restrict, char *__restrict, int mode, size_t size);
+
+// non-standard: copies up to size of the most recent bytes in the ring
+// log into buf, oldest first, returning how many were copied
+size_t ring_log_read(char *buf, size_t size);
 
 }
@@ -5,18 +5,20 @@
 #include <sys/cdefs.h>
 
 namespace _mm_internals {
-	// free memory start at 16MiB
-	static constexpr size_t FREE_MEM_LOW_ADDR = 0x01'00'00'00;
-	// assume there is at least 256MiB of free memory
-	// any more will not be used,
-	// any less will likely cause a crash or something
-	static constexpr size_t FREE_MEM_CAP = 0x10'00'00'00;
+	// a range [begin, end) of usable memory, as handed to init
+	struct mem_range_t {
+		uintptr_t begin;
+		uintptr_t end;
+	};
 
 	// stolen from https://git.sr.ht/~ruan_p/ministdlib/tree/master/item/src/ministd_memory.c#L42
 	using ALIGN = uint8_t[8];
 	union alloc_header_t {
 		struct {
 			size_t num_blocks;
+			// bytes asked for, so that realloc only needs to copy
+			// what's actually in use
+			size_t size;
 		} s;
 		ALIGN stub;
 	};
@@ -24,30 +26,328 @@ namespace _mm_internals {
 
 	// only allocate 1KiB+ of memory
 	static constexpr size_t MIN_ALLOC_SIZE = 1024;
-	static constexpr size_t NUM_BLOCKS = FREE_MEM_CAP / MIN_ALLOC_SIZE;
+	// bitsets are stored as 32-bit words, so that runs of blocks can be
+	// searched and updated a whole word at a time
+	static constexpr size_t BITS_PER_WORD = 32;
+	static constexpr uint32_t FULL_WORD = ~uint32_t(0);
+
+	// the heap is sized at boot from the memory map, see init.
+	// Blocks are counted from heap_base, and any blocks that aren't
+	// usable memory (holes, the kernel image, the allocator's own
+	// bookkeeping) are simply marked as used.
+	extern uintptr_t heap_base;
+	extern size_t num_blocks;
+	// num_blocks rounded up to whole regions (see below); the extra
+	// blocks at the end are always marked used
+	extern size_t num_words;
+	extern size_t num_regions;
+
 	// bitset to keep track of free blocks of memory
-	extern uint8_t is_used[NUM_BLOCKS / 8];
+	extern uint32_t *is_used;
+
+	// bitset of free blocks which are known to contain only zeroes, so
+	// that calloc doesn't have to clear them again.
+	// Blocks become dirty as soon as they're freed (before that they
+	// belong to whoever allocated them, and the bits mean nothing).
+	// Building with MM_ZEROED_RAM=1 assumes that all memory starts out
+	// zeroed, like it does in qemu
+	extern uint32_t *is_zero;
 
 	static inline bool get_used(size_t block_idx) {
-		// test the (block_idx % 8)'th bit of the (block_dix / 8)'th byte
-		return (is_used[block_idx/8] >> (block_idx&7)) & 1;
-	}
-	static inline void set_free(size_t block_idx) {
-		// reset the (block_idx % 8)'th bit of the (block_dix / 8)'th byte
-		is_used[block_idx/8] &= ~uint8_t(1 << (block_idx&7));
-	}
-	static inline void set_used(size_t block_idx) {
-		// set the (block_idx % 8)'th bit of the (block_dix / 8)'th byte
-		is_used[block_idx/8] |= 1 << (block_idx&7);
+		// test the (block_idx % 32)'th bit of the (block_idx / 32)'th word
+		return (is_used[block_idx/32] >> (block_idx&31)) & 1;
 	}
 	static inline void *get_ptr(size_t block_idx) {
-		return (void*)(FREE_MEM_LOW_ADDR + MIN_ALLOC_SIZE*block_idx);
+		return (void*)(heap_base + MIN_ALLOC_SIZE*block_idx);
 	}
 	static inline size_t get_idx(void *ptr) {
-		return (size_t(ptr) - FREE_MEM_LOW_ADDR) / MIN_ALLOC_SIZE;
+		return (uintptr_t(ptr) - heap_base) / MIN_ALLOC_SIZE;
+	}
+
+	// summary of the free runs in each 1024-block region, so that the
+	// whole bitmap doesn't have to be scanned to find space.
+	// The regions are the leaves of a binary tree, stored heap-style
+	// (children of node i are 2i and 2i+1, leaves are
+	// [num_regions, 2*num_regions)), where each node summarises the
+	// regions below it. num_regions is always a power of two, so that
+	// the tree is complete.
+	// Together with the words of is_used themselves (which show at a
+	// glance whether 32 blocks are full, empty or partially used), this
+	// gives a three-level index over the heap.
+	static constexpr size_t REGION_BLOCKS = 1024;
+	static constexpr size_t WORDS_PER_REGION = REGION_BLOCKS / BITS_PER_WORD;
+	struct run_summary_t {
+		// free blocks at the start and end of the covered range
+		uint32_t prefix;
+		uint32_t suffix;
+		// longest run of free blocks entirely within the range
+		uint32_t largest;
+	};
+	extern run_summary_t *summary;
+
+	// bring the summary up to date after blocks [begin, begin+count)
+	// changed state
+	void update_summary(size_t begin, size_t count);
+	// (re)build the whole summary from is_used
+	void rebuild_summary();
+
+	enum class RegionState {
+		Empty,
+		Partial,
+		Full,
+	};
+	static inline RegionState region_state(size_t region) {
+		const run_summary_t &leaf = summary[num_regions + region];
+		if (leaf.largest == 0) return RegionState::Full;
+		if (leaf.prefix == REGION_BLOCKS) return RegionState::Empty;
+		return RegionState::Partial;
+	}
+	static inline size_t largest_free_run() {
+		return summary[1].largest;
+	}
+
+	// running totals kept by malloc, free and realloc;
+	// apps should use sdk/memstats.hpp rather than poking at these
+	static constexpr size_t NUM_SIZE_BUCKETS = 16;
+	struct heap_stats_t {
+		// blocks which could be handed out at all, as found by init
+		size_t total_blocks;
+		// blocks in use, including slabs and partly used blocks
+		size_t live_blocks;
+		size_t peak_blocks;
+		// usable bytes of the live allocations (so rounded up to the
+		// slab size class or to whole blocks)
+		size_t live_bytes;
+		size_t peak_bytes;
+		size_t num_allocs;
+		size_t num_frees;
+		size_t reallocs_in_place;
+		size_t reallocs_copied;
+		// calloc'd bytes which were already known to be zero
+		size_t zeroing_skipped;
+		// allocations by requested size: bucket i counts sizes up to
+		// 8 << i bytes, and the last bucket everything bigger
+		size_t size_buckets[NUM_SIZE_BUCKETS];
+	};
+	extern heap_stats_t stats;
+
+	static inline size_t size_bucket(size_t size) {
+		if (size <= 8) return 0;
+		const size_t bucket = 32 - __builtin_clz(uint32_t(size-1)) - 3;
+		return bucket < NUM_SIZE_BUCKETS ? bucket : NUM_SIZE_BUCKETS-1;
+	}
+	static inline void stats_add_bytes(size_t bytes) {
+		stats.live_bytes += bytes;
+		if (stats.live_bytes > stats.peak_bytes) {
+			stats.peak_bytes = stats.live_bytes;
+		}
+	}
+
+#ifdef MM_TRACE_CALLERS
+	// allocation-site profiling, switched on with MM_TRACE_CALLERS=1 in
+	// build.sh: every allocation is counted against the address it was
+	// made from, in a fixed-size hash table
+	static constexpr size_t NUM_CALLER_SLOTS = 256;
+	struct caller_stats_t {
+		void *addr;
+		size_t allocs;
+		size_t bytes;
+	};
+	extern caller_stats_t callers[NUM_CALLER_SLOTS];
+	// allocations which didn't fit in the table
+	extern size_t untraced_allocs;
+
+	void trace_caller(void *caller, size_t size);
+#define _MM_TRACE_CALLER(size) _mm_internals::trace_caller(__builtin_return_address(0), (size))
+#else
+#define _MM_TRACE_CALLER(size) ((void)0)
+#endif
+
+	// mask of the bits [bit, bit+len) in a word
+	static inline uint32_t span_mask(size_t bit, size_t len) {
+		if (len >= BITS_PER_WORD) return FULL_WORD;
+		return ((uint32_t(1) << len) - 1) << bit;
+	}
+	// calls fn(word_idx, mask) for each word covered by the given blocks
+	template<typename Fn>
+	static inline void for_each_span_word(size_t begin, size_t count, Fn fn) {
+		while (count) {
+			const size_t bit = begin%BITS_PER_WORD;
+			const size_t len = count < BITS_PER_WORD - bit
+				? count
+				: BITS_PER_WORD - bit;
+
+			fn(begin/BITS_PER_WORD, span_mask(bit, len));
+
+			begin += len;
+			count -= len;
+		}
 	}
+	static inline void set_used_span(size_t begin, size_t count) {
+		for_each_span_word(begin, count, [](size_t word, uint32_t mask) {
+			is_used[word] |= mask;
+		});
+		update_summary(begin, count);
+
+		stats.live_blocks += count;
+		if (stats.live_blocks > stats.peak_blocks) {
+			stats.peak_blocks = stats.live_blocks;
+		}
+	}
+	static inline void set_free_span(size_t begin, size_t count) {
+		for_each_span_word(begin, count, [](size_t word, uint32_t mask) {
+			is_used[word] &= ~mask;
+			is_zero[word] &= ~mask;
+		});
+		update_summary(begin, count);
+
+		stats.live_blocks -= count;
+	}
+	static inline bool is_used_span(size_t begin, size_t count) {
+		bool res = true;
+		for_each_span_word(begin, count, [&res](size_t word, uint32_t mask) {
+			res = res && (is_used[word] & mask) == mask;
+		});
+		return res;
+	}
+	static inline bool is_free_span(size_t begin, size_t count) {
+		bool res = true;
+		for_each_span_word(begin, count, [&res](size_t word, uint32_t mask) {
+			res = res && (is_used[word] & mask) == 0;
+		});
+		return res;
+	}
+	static inline bool is_zero_span(size_t begin, size_t count) {
+		bool res = true;
+		for_each_span_word(begin, count, [&res](size_t word, uint32_t mask) {
+			res = res && (is_zero[word] & mask) == mask;
+		});
+		return res;
+	}
+	// the number of free blocks directly from begin, counting up to max
+	size_t free_run_length(size_t begin, size_t max);
+	// the number of free blocks directly before begin, counting up to max
+	size_t free_run_length_before(size_t begin, size_t max);
+
+	// how find_free_run chooses between runs of free blocks
+	enum class Placement {
+		// the lowest-addressed run that fits
+		FirstFit,
+		// spread allocations out over the whole heap, so that reallocs
+		// are more likely to be able to grow in place
+		Strided,
+	};
+	extern Placement placement;
+
+	// find `count` contiguous free blocks, starting at a block index
+	// which is a multiple of `align`.
+	// returns num_blocks if there is no such run of blocks
+	size_t find_free_run(size_t count, size_t align = 1);
+
+	// the block allocator proper, which hands out runs of blocks to
+	// malloc, realloc and the slab allocator.
+	// There are two implementations, picked in build.sh: the default
+	// first-fit search over the bitsets above (_mm_bitmap.cpp), and a
+	// binary buddy allocator (_mm_buddy.cpp). Either way is_used and the
+	// summary are kept up to date, so they can be used to inspect the heap.
+	extern const char *const backend_name;
+	// the number of blocks actually handed out for a request of `count`
+	// blocks; this is what should be passed back to the other functions
+	size_t round_blocks(size_t count);
+	// allocate round_blocks(count) blocks, starting at a block index which
+	// is a multiple of `align`.
+	// returns num_blocks if there isn't enough free memory
+	size_t alloc_blocks(size_t count, size_t align = 1);
+	void free_blocks(size_t begin, size_t count);
+	// grow an allocation from `curr` to `req` blocks without moving it,
+	// returns false if the memory after it isn't free
+	bool grow_blocks(size_t begin, size_t curr, size_t req);
+	void shrink_blocks(size_t begin, size_t curr, size_t req);
+	// grow an allocation from `curr` to `req` blocks into the free memory
+	// both before and after it, returning where it now starts (the caller
+	// has to move the contents there), or num_blocks if it can't
+	size_t grow_blocks_backwards(size_t begin, size_t curr, size_t req);
+	// whether the backend keeps its own data in the given free block
+	// (which mustn't be zeroed)
+	bool backend_keeps_data(size_t block);
+	// extra bookkeeping the backend needs, which init places along with
+	// the bitsets and hands to backend_init once they're set up
+	size_t backend_meta_size();
+	void backend_init(void *meta);
+
+	// zero the blocks in the span which aren't known to be zero,
+	// returns the number of blocks which had to be zeroed
+	size_t zero_dirty_blocks(size_t begin, size_t count);
+	// zero up to `max` dirty free blocks, so that they won't need to be
+	// cleared when they're calloc'd; meant to be called when there's
+	// nothing better to do. returns the number of blocks zeroed
+	size_t zero_free_blocks(size_t max);
+
+	// set up the allocator to manage the given ranges of usable memory;
+	// needs to be called before anything is allocated.
+	// The ranges needn't be sorted or block-aligned, but mustn't overlap
+	// anything else that's in use (like the kernel image).
+	// The bitsets and summary are placed in the first range with enough
+	// room for them.
+	void init(const mem_range_t *usable, size_t count);
+
+	// slab allocator for small objects:
+	// objects of up to SLAB_MAX_SIZE bytes are rounded up to a power of
+	// two and packed into 4KiB slabs, instead of each taking a whole block
+	static constexpr size_t SLAB_MIN_SIZE = 8;
+	static constexpr size_t SLAB_MAX_SIZE = 512;
+	static constexpr size_t NUM_SLAB_CLASSES = 7; // 8, 16, ..., 512
+	static constexpr size_t SLAB_BLOCKS = 4;
+	// can be switched off to compare against plain block allocation;
+	// objects already in slabs are still freed correctly
+	extern bool slab_enabled;
+
+	// bitset to keep track of which blocks are used by slabs
+	extern uint32_t *is_slab;
+
+	static inline bool get_slab(size_t block_idx) {
+		return (is_slab[block_idx/32] >> (block_idx&31)) & 1;
+	}
+	static inline void clear_slab_span(size_t begin, size_t count) {
+		for_each_span_word(begin, count, [](size_t word, uint32_t mask) {
+			is_slab[word] &= ~mask;
+		});
+	}
+	static inline void set_slab_span(size_t begin, size_t count) {
+		for_each_span_word(begin, count, [](size_t word, uint32_t mask) {
+			is_slab[word] |= mask;
+		});
+	}
+
+	// if `zero` is set, the object is cleared (when it isn't known to be
+	// zero already)
+	void *slab_alloc(size_t size, bool zero = false);
+	void slab_free(void *p);
+	// the size of the size class the object was allocated from
+	size_t slab_size(void *p);
+
+	// how many bytes can actually be used at p, which might be more than
+	// were asked for
+	size_t usable_size(void *p);
+
+	// malloc, free and realloc themselves, without the caller tracing,
+	// so that they can be used by the other allocation functions
+	void *alloc(size_t size, bool zero = false);
+	void release(void *p);
+	void *resize(void *p, size_t size);
 }
 
+// non-standard number to string conversions, used by printf and sdk::fmt.
+// These write into buf without a null terminator, and return how many
+// characters were written; buf needs room for the longest possible result
+static constexpr size_t UTOA32_MAX = 10;
+static constexpr size_t UTOA64_MAX = 20;
+// sign, 17 digits, decimal point and up to 5 leading zeros or a 5-char
+// exponent, or up to 20 digits before the decimal point
+static constexpr size_t DTOA_MAX = 32;
+// precisions past this are cut down to it
+static constexpr int DTOA_FIXED_MAX_PRECISION = 18;
+
 extern "C" {
 
 __attribute__((__noreturn__))
@@ -59,4 +359,22 @@ void *calloc(size_t, size_t);
 void *realloc(void *, size_t);
 void *reallocarray(void *, size_t, size_t);
 
+// how many bytes can be used at the pointer, which may be more than
+// were asked for. Claims all of them for the allocation, so that realloc
+// keeps their contents as well
+size_t malloc_usable_size(void *);
+
+// non-standard, see above
+size_t utoa32(uint32_t value, char *buf);
+size_t utoa64(uint64_t value, char *buf);
+// the shortest digits which read back as exactly d (so 0.1 gives "0.1"),
+// in plain notation where that's reasonably short and as eg. "1.5e+30"
+// otherwise.
+// Up to DTOA_MAX characters
+size_t dtoa(double d, char *buf);
+// with exactly `precision` digits after the decimal point (none and no
+// decimal point if it's 0); values too big for that are written as by dtoa.
+// Up to DTOA_MAX + DTOA_FIXED_MAX_PRECISION characters
+size_t dtoa_fixed(double d, int precision, char *buf);
+
 }
@@ -3,14 +3,30 @@
 #include <sys/cdefs.h>
 
 #include <stddef.h>
+#include <stdint.h>
+
+namespace _string_internals {
+	// whether strlen & co. can use their SSE2 versions, as decided by
+	// init at boot from CPUID. Until then the plain versions are used
+	extern bool use_sse2;
+	// whether the CPU has fast `rep movsb` (ERMSB), which memcpy then
+	// uses for big copies; also decided by init
+	extern bool use_rep_movsb;
+	void init();
+}
 
 extern "C" {
 
+void *memchr(const void *, int, size_t);
 int memcmp(const void *, const void *, size_t);
 void *memcpy(void *__restrict, const void *__restrict, size_t);
 void *memmove(void *, const void *, size_t n);
 void *memset(void *, int, size_t);
+// non-standard: fill `count` 16-bit or 32-bit values, eg. vga entries
+void *memset16(void *, uint16_t, size_t count);
+void *memset32(void *, uint32_t, size_t count);
 
+char *strchr(const char *, int);
 int strcmp(const char *s1, const char *s2);
 int strncmp(const char *s1, const char *s2, size_t n);
 size_t strlen(const char *);
@@ -0,0 +1,53 @@
+#pragma once
+
+// https://www.gnu.org/software/grub/manual/multiboot/multiboot.html
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <stdlib.h>
+
+// what the bootloader leaves in eax
+#define MULTIBOOT_BOOTLOADER_MAGIC 0x2BADB002
+
+#define MULTIBOOT_INFO_MEMORY (1 << 0) // mem_lower and mem_upper are valid
+#define MULTIBOOT_INFO_MEM_MAP (1 << 6) // mmap_length and mmap_addr are valid
+
+#define MULTIBOOT_MEMORY_AVAILABLE 1
+
+namespace multiboot {
+
+// only the fields up to the memory map, which is all that's used
+struct info_t {
+	uint32_t flags;
+	// in KiB, memory below 1MiB and from 1MiB up to the first hole
+	uint32_t mem_lower;
+	uint32_t mem_upper;
+	uint32_t boot_device;
+	uint32_t cmdline;
+	uint32_t mods_count;
+	uint32_t mods_addr;
+	uint32_t syms[4];
+	uint32_t mmap_length;
+	uint32_t mmap_addr;
+} __attribute__((packed));
+
+struct mmap_entry_t {
+	// the size of the rest of the entry, which may be more than the
+	// fields below
+	uint32_t size;
+	uint64_t addr;
+	uint64_t len;
+	uint32_t type;
+} __attribute__((packed));
+
+// at most this many ranges are reported by usable_memory
+static constexpr size_t MAX_RANGES = 32;
+
+// find the usable memory from 1MiB up, leaving out the kernel image.
+// Falls back on mem_upper if there is no memory map, and on a hardcoded
+// guess if the kernel wasn't booted by multiboot at all.
+// returns the number of ranges written to `ranges`
+size_t usable_memory(uint32_t magic, const info_t *info, _mm_internals::mem_range_t ranges[MAX_RANGES]);
+
+}
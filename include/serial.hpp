@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* see https://wiki.osdev.org/Serial_Ports */
+
+#define COM1 0x3F8
+
+#define SERIAL_DATA(port) (port) /* with DLAB set: divisor low byte */
+#define SERIAL_INT_ENABLE(port) ((port)+1) /* with DLAB set: divisor high byte */
+#define SERIAL_FIFO_CTRL(port) ((port)+2)
+#define SERIAL_LINE_CTRL(port) ((port)+3)
+#define SERIAL_MODEM_CTRL(port) ((port)+4)
+#define SERIAL_LINE_STATUS(port) ((port)+5)
+
+#define SERIAL_LINE_DLAB 0x80
+#define SERIAL_LINE_8N1 0x03
+#define SERIAL_STATUS_THR_EMPTY 0x20
+
+/* the UART's transmit FIFO, on a 16550 */
+#define SERIAL_FIFO_SIZE 16
+
+namespace serial {
+	// set up COM1 at 38400 baud, 8N1, polled (no interrupts).
+	// returns false if there's no working port, in which case everything
+	// written is dropped
+	bool init();
+
+	// blocks until it's all been handed to the UART; '\n' is sent as
+	// "\r\n"
+	void write(const char *data, size_t size);
+}
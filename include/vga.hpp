@@ -8,6 +8,8 @@ namespace vga {
 constexpr size_t WIDTH  = 80;
 constexpr size_t HEIGHT = 25;
 constexpr size_t ADDR   = 0xB8000;
+// text mode memory starting at ADDR, of which the screen shows a window
+constexpr size_t MEMORY_SIZE = 0x8000;
 
 /* Hardware text mode color constants. */
 enum class Color : uint8_t {
@@ -49,15 +51,59 @@ constexpr static inline entry_t entry(uint8_t b, entry_color_t color) {
 
 namespace term {
 
+// while one of these exists, term draws into it instead of the screen, and
+// when the last one goes away whatever was drawn is written to the screen
+// in one go. Only the parts of rows which were actually drawn to are
+// written back
 class Backbuffer {
 	static size_t instance_count;
 	vga::entry_t buffer[vga::WIDTH*vga::HEIGHT];
 	bool was_moving_cursor;
 public:
-	Backbuffer();
+	enum class Init {
+		// start out with what's on the screen
+		CopyScreen,
+		// start out cleared (like term::clear()), for callers which
+		// redraw everything anyway, so that the screen needn't be read
+		Clear,
+	};
+
+	Backbuffer(Init init = Init::CopyScreen);
 	~Backbuffer();
 };
 
+// page flipping, for apps which redraw the whole screen every frame: while
+// one of these exists, term draws into a page of VGA memory which isn't on
+// the screen, and flip shows it (once the screen has been drawn, so that
+// it doesn't tear) and hands over the page that was on the screen to draw
+// the next frame into. Nothing is copied, but that also means the page
+// being drawn into starts out with whatever was there two frames ago, so
+// everything has to be redrawn. Backbuffers and frames do nothing while
+// flipping, since everything is off-screen already
+class FlipBuffer {
+	bool was_moving_cursor;
+public:
+	FlipBuffer();
+	~FlipBuffer();
+
+	FlipBuffer(const FlipBuffer&) = delete;
+	FlipBuffer &operator=(const FlipBuffer&) = delete;
+
+	// waits for retrace, so that the page drawn into is on the screen and
+	// the old one can be drawn into straight away. Apps which don't start
+	// on their next frame for at least a refresh (1/70s) can skip the
+	// wait, since it's port I/O in a loop, and in a VM each read traps
+	void flip(bool wait_for_retrace = true);
+};
+
+// present mode, for apps which redraw the whole screen every frame:
+// after begin_frame, term draws into an off-screen frame (starting out as
+// what's on the screen), and present then compares it against a copy of
+// what's on the screen, and only writes the cells which changed.
+// Not to be mixed with Backbuffer
+void begin_frame();
+void present();
+
 void init();
 void clear();
 void go_to(size_t x, size_t y);
@@ -68,9 +114,18 @@ void putentryat(vga::entry_t entry, size_t x, size_t y); /* WARN: no bounds chec
 void putbyteat(uint8_t byte, vga::entry_color_t color, size_t x, size_t y); /* WARN: no bounds checking */
 void enable_autoscroll();
 void disable_autoscroll();
+// hardware scrolling (on by default): scrolling the screen moves the part
+// of VGA memory which is shown further down, instead of copying everything
+// up, so that only the newly exposed rows need to be written. Doesn't
+// apply inside a Backbuffer or frame, where scrolling is done in RAM
+void enable_hardware_scroll();
+void disable_hardware_scroll();
 void scroll(size_t lines);
+// the part of VGA memory which is currently on the screen
+volatile vga::entry_t *screen();
 void advance();
 void putbyte(uint8_t byte);
+void putbytes(uint8_t byte, size_t count);
 void putchar(char c);
 void backspace();
 void write_raw(const uint8_t *data, size_t size);
@@ -85,7 +140,12 @@ bool is_enabled();
 void enable();
 void enable(uint8_t cursor_start, uint8_t cursor_end);
 void disable();
+// outside of term's writes this moves the cursor straight away, inside
+// them only once they're done
 void go_to(size_t x, size_t y);
+// moves the hardware cursor to where go_to last put it, if it isn't
+// already there; term does this at the end of each write
+void sync();
 uint16_t getpos();
 size_t getx();
 size_t gety();
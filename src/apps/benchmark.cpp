@@ -0,0 +1,514 @@
+#include "apps/benchmark.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sdk/arena.hpp>
+#include <sdk/random.hpp>
+#include <sdk/util.hpp>
+
+#include "ps2.hpp"
+#include "vga.hpp"
+
+#include "apps/components/menu.hpp"
+
+namespace benchmark {
+
+namespace {
+
+using namespace sdk::util;
+
+inline uint64_t rdtsc() {
+	uint32_t lo, hi;
+	__asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+	return (uint64_t(hi) << 32) | lo;
+}
+
+size_t count_used_blocks() {
+	size_t res = 0;
+	for (size_t i = 0; i < _mm_internals::num_words; ++i) {
+		res += __builtin_popcount(_mm_internals::is_used[i]);
+	}
+	return res;
+}
+
+void wait_for_key() {
+	puts("");
+	puts("Press any key to return.");
+
+	for (;;) {
+		__asm__ volatile("hlt" ::: "memory");
+
+		while (!ps2::events.empty()) {
+			if (ps2::events.pop().type == ps2::EventType::Press) return;
+		}
+	}
+}
+
+namespace alloc {
+
+// roughly what the text editor does to its List<String> while typing:
+// lines get inserted in the middle of the file, characters get appended
+// to them one at a time, and every so often a line gets split in two
+constexpr size_t WORKLOAD_LINES = 256;
+constexpr size_t WORKLOAD_LINE_LEN = 72;
+constexpr size_t WORKLOAD_STRINGS = 1024;
+
+struct Result {
+	size_t blocks;
+	uint32_t cycles_per_line;
+	uint32_t cycles_per_string;
+};
+
+Result run_list_string_workload() {
+	Result res;
+
+	const size_t blocks_before = count_used_blocks();
+	const uint64_t workload_begin = rdtsc();
+	{
+		List<String> lines {};
+
+		for (size_t i = 0; i < WORKLOAD_LINES; ++i) {
+			const size_t at = lines.size()/2;
+			lines.insert(at, String());
+
+			auto &line = lines[at];
+			for (size_t j = 0; j < WORKLOAD_LINE_LEN; ++j) {
+				line.insert(line.size(), char('a' + j%26));
+			}
+
+			if (i%8 == 7) {
+				lines.insert(at+1, line.substr(WORKLOAD_LINE_LEN/2));
+				line.erase(WORKLOAD_LINE_LEN/2);
+			}
+		}
+
+		res.blocks = count_used_blocks() - blocks_before;
+	}
+	res.cycles_per_line = (rdtsc() - workload_begin) / WORKLOAD_LINES;
+
+	const uint64_t strings_begin = rdtsc();
+	for (size_t i = 0; i < WORKLOAD_STRINGS; ++i) {
+		const String str("The quick brown fox jumps over the lazy dog.");
+		(void)str;
+	}
+	res.cycles_per_string = (rdtsc() - strings_begin) / WORKLOAD_STRINGS;
+
+	return res;
+}
+
+void print_result(const char *name, const Result &res) {
+	puts(name);
+	printf("  heap footprint: %u KiB (%u blocks)\n",
+		res.blocks * _mm_internals::MIN_ALLOC_SIZE / 1024,
+		res.blocks
+	);
+	printf("  cycles per line typed: %u\n", res.cycles_per_line);
+	printf("  cycles per String created + destroyed: %u\n", res.cycles_per_string);
+}
+
+void list_string() {
+	puts("Allocator benchmark: text editor List<String> workload");
+	printf("block allocator: %s\n", _mm_internals::backend_name);
+	printf("%u lines of %u characters, %u short Strings\n\n",
+		WORKLOAD_LINES, WORKLOAD_LINE_LEN, WORKLOAD_STRINGS
+	);
+
+	const bool was_slab_enabled = _mm_internals::slab_enabled;
+
+	_mm_internals::slab_enabled = false;
+	const Result before = run_list_string_workload();
+	_mm_internals::slab_enabled = true;
+	const Result after = run_list_string_workload();
+
+	_mm_internals::slab_enabled = was_slab_enabled;
+
+	print_result("Block allocator only:", before);
+	print_result("With slab allocator:", after);
+
+	wait_for_key();
+}
+
+// number of single-block allocations to chop the heap up with;
+// every second one gets freed again, leaving one-block holes
+constexpr size_t FRAGMENT_ALLOCS = 16384;
+constexpr size_t FRAGMENT_SEARCHES = 16;
+constexpr size_t FRAGMENT_RUN_LENGTHS[] = { 1, 2, 8, 64 };
+
+// the block search as it was before it was done a word at a time,
+// kept around as a point of reference
+size_t find_free_run_bitwise(size_t count) {
+	using namespace _mm_internals;
+
+	size_t spacing = num_blocks / 512 / 32 * 32;
+	if (spacing < 32) spacing = 32;
+	for (size_t small_step = 0; small_step < spacing; ++small_step) {
+		for (size_t large_step = 0; large_step < num_blocks; large_step += spacing) {
+			const size_t i = large_step + small_step;
+
+			if (i + count > num_blocks) break;
+
+			for (size_t j = 0; j < count; ++j) {
+				if (get_used(i+j)) goto no_alloc;
+			}
+
+			return i;
+
+		no_alloc:;
+		}
+	}
+
+	return num_blocks;
+}
+
+uint32_t time_search(size_t count, size_t (*search)(size_t)) {
+	const uint64_t begin = rdtsc();
+	for (size_t i = 0; i < FRAGMENT_SEARCHES; ++i) {
+		search(count);
+	}
+	return (rdtsc() - begin) / FRAGMENT_SEARCHES;
+}
+
+void fragmented_search() {
+	using namespace _mm_internals;
+
+	puts("Allocator benchmark: searching a fragmented heap");
+	printf("%u one-block allocations, every second one freed\n\n",
+		FRAGMENT_ALLOCS
+	);
+
+	const bool was_slab_enabled = slab_enabled;
+	const Placement prev_placement = placement;
+	slab_enabled = false;
+
+	// pack the allocations together so that the holes between them
+	// are as small as possible
+	placement = Placement::FirstFit;
+	void **allocs = (void**)calloc(FRAGMENT_ALLOCS, sizeof(void*));
+	for (size_t i = 0; i < FRAGMENT_ALLOCS; ++i) {
+		allocs[i] = malloc(MIN_ALLOC_SIZE - HEADER_SIZE);
+	}
+	for (size_t i = 0; i < FRAGMENT_ALLOCS; i += 2) {
+		free(allocs[i]);
+	}
+
+	puts("cycles per search (blocks: bit at a time / strided / first fit)");
+	for (const size_t count : FRAGMENT_RUN_LENGTHS) {
+		const uint32_t bitwise = time_search(count, find_free_run_bitwise);
+		placement = Placement::Strided;
+		const uint32_t strided = time_search(count, [](size_t count) {
+			return find_free_run(count);
+		});
+		placement = Placement::FirstFit;
+		const uint32_t first_fit = time_search(count, [](size_t count) {
+			return find_free_run(count);
+		});
+
+		printf("  %u: %u / %u / %u\n", count, bitwise, strided, first_fit);
+	}
+
+	for (size_t i = 1; i < FRAGMENT_ALLOCS; i += 2) {
+		free(allocs[i]);
+	}
+	free(allocs);
+
+	placement = prev_placement;
+	slab_enabled = was_slab_enabled;
+
+	wait_for_key();
+}
+
+// the pattern the editor's lines go through: buffers growing and
+// shrinking a bit at a time, all interleaved with each other
+constexpr size_t CHURN_BUFFERS = 64;
+constexpr size_t CHURN_REALLOCS = 8192;
+constexpr size_t CHURN_MAX_SIZE = 32*1024;
+
+void grow_shrink() {
+	using namespace _mm_internals;
+
+	puts("Allocator benchmark: grow/shrink churn");
+	printf("block allocator: %s\n", backend_name);
+	printf("%u buffers, %u reallocs of up to %u KiB\n\n",
+		CHURN_BUFFERS, CHURN_REALLOCS, CHURN_MAX_SIZE/1024
+	);
+
+	sdk::random::Xorshift32 rng(0xB0DD1E5);
+
+	void *buffers[CHURN_BUFFERS];
+	size_t sizes[CHURN_BUFFERS];
+	for (size_t i = 0; i < CHURN_BUFFERS; ++i) {
+		sizes[i] = 1024;
+		buffers[i] = malloc(sizes[i]);
+	}
+
+	uint64_t total_cycles = 0;
+	uint32_t worst_cycles = 0;
+	for (size_t i = 0; i < CHURN_REALLOCS; ++i) {
+		const size_t buf = rng.next() % CHURN_BUFFERS;
+		const size_t step = 256 + rng.next() % 4096;
+
+		size_t &size = sizes[buf];
+		if (rng.next() % 3 != 0) {
+			size = size + step > CHURN_MAX_SIZE ? CHURN_MAX_SIZE : size + step;
+		} else {
+			size = size > step + 1 ? size - step : 1;
+		}
+
+		const uint64_t begin = rdtsc();
+		buffers[buf] = realloc(buffers[buf], size);
+		const uint32_t cycles = rdtsc() - begin;
+
+		total_cycles += cycles;
+		if (cycles > worst_cycles) worst_cycles = cycles;
+	}
+
+	// how badly chopped up is the free memory while all the buffers
+	// are still live?
+	const size_t free_blocks = num_words*BITS_PER_WORD - count_used_blocks();
+	const size_t largest = largest_free_run();
+
+	for (size_t i = 0; i < CHURN_BUFFERS; ++i) {
+		free(buffers[i]);
+	}
+
+	printf("cycles per realloc: %u average, %u worst\n",
+		uint32_t(total_cycles / CHURN_REALLOCS), worst_cycles
+	);
+	printf("free memory: %u KiB, largest free run: %u KiB\n",
+		free_blocks * MIN_ALLOC_SIZE / 1024,
+		largest * MIN_ALLOC_SIZE / 1024
+	);
+	printf("fragmentation: %u%%\n",
+		free_blocks ? 100 - uint32_t(uint64_t(largest) * 100 / free_blocks) : 0
+	);
+
+	wait_for_key();
+}
+
+// what a frame of drawing text might do: put together a bunch of short
+// lived Strings, collect them in a List, and throw them all away again
+constexpr size_t FRAME_COUNT = 64;
+constexpr size_t FRAME_STRINGS = 32;
+
+uint32_t time_frames(sdk::Arena *arena) {
+	const uint64_t begin = rdtsc();
+	for (size_t frame = 0; frame < FRAME_COUNT; ++frame) {
+		const auto mark = arena ? arena->mark() : sdk::Arena::Mark {};
+		{
+			List<String> lines(FRAME_STRINGS, arena);
+			for (size_t i = 0; i < FRAME_STRINGS; ++i) {
+				String line("line ", arena);
+				line += char('0' + i%10);
+				lines.push_back(line + ": the quick brown fox");
+			}
+		}
+		if (arena) arena->reset(mark);
+	}
+	return (rdtsc() - begin) / FRAME_COUNT;
+}
+
+void frame_temporaries() {
+	puts("Allocator benchmark: per-frame temporaries");
+	printf("%u frames of %u Strings each\n\n", FRAME_COUNT, FRAME_STRINGS);
+
+	sdk::Arena arena {};
+
+	const uint32_t heap = time_frames(nullptr);
+	const uint32_t scratch = time_frames(&arena);
+
+	puts("cycles per frame (heap / arena)");
+	printf("  %u / %u\n", heap, scratch);
+
+	wait_for_key();
+}
+
+// small nodes like those of a timer or task queue, made and thrown
+// away all the time
+struct Node {
+	uint32_t deadline;
+	void *arg;
+	Node *next;
+};
+constexpr size_t POOL_OBJECTS = 1024;
+constexpr size_t POOL_ROUNDS = 16;
+
+template<typename New, typename Delete>
+uint32_t time_nodes(New make, Delete destroy) {
+	Node *nodes[POOL_OBJECTS];
+
+	const uint64_t begin = rdtsc();
+	for (size_t round = 0; round < POOL_ROUNDS; ++round) {
+		for (size_t i = 0; i < POOL_OBJECTS; ++i) {
+			nodes[i] = make(i);
+		}
+		// free them out of order, so that the free list gets shuffled
+		for (size_t i = 0; i < POOL_OBJECTS; i += 2) {
+			destroy(nodes[i]);
+		}
+		for (size_t i = 1; i < POOL_OBJECTS; i += 2) {
+			destroy(nodes[i]);
+		}
+	}
+	return (rdtsc() - begin) / (POOL_ROUNDS*POOL_OBJECTS);
+}
+
+void object_pool() {
+	puts("Allocator benchmark: object pool vs new/delete");
+	printf("%u rounds of %u %u-byte objects\n\n",
+		POOL_ROUNDS, POOL_OBJECTS, sizeof(Node)
+	);
+
+	const uint32_t heap = time_nodes(
+		[](size_t i) { return new Node { uint32_t(i), nullptr, nullptr }; },
+		[](Node *node) { delete node; }
+	);
+
+	Pool<Node, 128> pool {};
+	const uint32_t pooled = time_nodes(
+		[&pool](size_t i) { return pool.construct(Node { uint32_t(i), nullptr, nullptr }); },
+		[&pool](Node *node) { pool.destroy(node); }
+	);
+
+	puts("cycles per object constructed + destroyed (new/delete / pool)");
+	printf("  %u / %u\n", heap, pooled);
+#ifdef SDK_POOL_STATS
+	printf("pool: %u objects constructed, peak %u live, capacity %u\n",
+		pool.constructed(), pool.peak(), pool.capacity()
+	);
+#else
+	printf("pool: capacity %u\n", pool.capacity());
+#endif
+
+	wait_for_key();
+}
+
+}
+
+namespace string {
+
+constexpr size_t COPY_SIZES[] = { 16, 4*1024, 1024*1024 };
+// copy about the same number of bytes at each size
+constexpr size_t COPY_TOTAL = 4*1024*1024;
+
+// memcpy as it was before it copied more than a byte at a time,
+// kept around as a point of reference
+__attribute__((noinline))
+void *memcpy_bytewise(void *__restrict dest, const void *__restrict src, size_t n) {
+	for (size_t i = 0; i < n; ++i) {
+		((uint8_t*)dest)[i] = ((const uint8_t*)src)[i];
+	}
+	return dest;
+}
+
+// nothing but `rep movsb`, which memcpy only uses for big copies, and only
+// on CPUs where it's fast
+__attribute__((noinline))
+void *memcpy_rep_movsb(void *__restrict dest, const void *__restrict src, size_t n) {
+	void *d = dest;
+	__asm__ volatile(
+		"rep movsb"
+		: "+D"(d), "+S"(src), "+c"(n)
+		:
+		: "memory"
+	);
+	return dest;
+}
+
+// in bytes per 100 cycles, so that the sizes can be compared
+uint32_t time_copy(void *(*copy)(void*, const void*, size_t), uint8_t *dest, const uint8_t *src, size_t size) {
+	const size_t reps = COPY_TOTAL / size;
+
+	const uint64_t begin = rdtsc();
+	for (size_t i = 0; i < reps; ++i) {
+		copy(dest, src, size);
+	}
+	const uint64_t cycles = rdtsc() - begin;
+
+	return cycles ? uint64_t(reps) * size * 100 / cycles : 0;
+}
+
+void copy() {
+	puts("String benchmark: memcpy/memmove throughput");
+	printf("%u KiB copied at each size\n\n", COPY_TOTAL/1024);
+
+	const size_t max_size = COPY_SIZES[sizeof(COPY_SIZES)/sizeof(*COPY_SIZES) - 1];
+	// one buffer with room to copy both ways, overlapping, for memmove
+	uint8_t *buf = (uint8_t*)malloc(2*max_size + 64);
+	assert(buf != NULL);
+	uint8_t *const src = buf;
+	uint8_t *const dest = buf + max_size + 32;
+
+	printf("fast rep movsb: %s\n\n", _string_internals::use_rep_movsb ? "yes" : "no");
+
+	puts("bytes per 100 cycles");
+	puts("(byte loop / rep movsb / memcpy / memmove backwards)");
+	for (const size_t size : COPY_SIZES) {
+		const uint32_t bytewise = time_copy(memcpy_bytewise, dest, src, size);
+		const uint32_t movsb = time_copy(memcpy_rep_movsb, dest, src, size);
+		const uint32_t fast = time_copy(memcpy, dest, src, size);
+		// the destination overlaps the end of the source, so it has to
+		// go from the top down
+		const uint32_t backwards = time_copy(memmove, src + size/2 + 1, src, size);
+
+		if (size >= 1024) printf("  %u KiB: ", size/1024);
+		else printf("  %u B: ", size);
+		printf("%u / %u / %u / %u\n", bytewise, movsb, fast, backwards);
+	}
+
+	free(buf);
+
+	wait_for_key();
+}
+
+}
+
+bool should_quit = false;
+
+using BenchFn = void(*)();
+
+void run(BenchFn fn) {
+	fn();
+}
+
+const List<menu::Entry<BenchFn>> menu_entries({
+	{ "Allocator: text editor List<String> workload", run, alloc::list_string },
+	{ "Allocator: searching a fragmented heap", run, alloc::fragmented_search },
+	{ "Allocator: grow/shrink churn", run, alloc::grow_shrink },
+	{ "Allocator: per-frame temporaries", run, alloc::frame_temporaries },
+	{ "Allocator: object pool vs new/delete", run, alloc::object_pool },
+	{ "String: memcpy/memmove throughput", run, string::copy },
+	{ "Back to main menu", run, []() { should_quit = true; } },
+});
+const List<menu::Entry<BenchFn>> hidden_menu_entries {};
+
+}
+
+void main() {
+	should_quit = false;
+
+	menu::Menu<BenchFn> menu(
+		menu_entries,
+		hidden_menu_entries,
+		"BENCHMARKS"
+	);
+
+	menu.draw();
+
+	while (!should_quit) {
+		__asm__ volatile("hlt" ::: "memory");
+
+		bool should_redraw = false;
+		while (!should_quit && !ps2::events.empty()) {
+			should_redraw = true;
+
+			menu.handle_key(ps2::events.pop());
+		}
+		if (should_redraw && !should_quit) menu.draw();
+	}
+}
+
+}
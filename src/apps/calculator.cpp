@@ -49,21 +49,30 @@ struct StringStore {
 	}
 };
 
+struct Variable {
+	const char *name;
+	int value;
+	Variable *next;
+};
+
 struct Memory {
 	// persistent storage
 
 	int prev_result = 0;
 	StringStore variable_names {};
-	List<Pair<const char*, int>> variables;
+	// variables are never removed, so they can just be chained together;
+	// being in a pool means that they don't move when more get added
+	Pool<Variable, 32> variable_pool {};
+	Variable *variables = nullptr;
 
 	int* get_variable(const char *name) {
 		return get_variable(name, strlen(name));
 	}
 	int* get_variable(const char *name, size_t name_len) {
-		for (auto &var : variables) {
-			if (strlen(var.first) != name_len) continue;
-			if (strncmp(var.first, name, name_len) == 0) {
-				return &var.second;
+		for (Variable *var = variables; var; var = var->next) {
+			if (strlen(var->name) != name_len) continue;
+			if (strncmp(var->name, name, name_len) == 0) {
+				return &var->value;
 			}
 		}
 
@@ -77,9 +86,10 @@ struct Memory {
 		if (val) {
 			*val = value;
 		} else {
-			variables.push_back({
+			variables = variable_pool.construct(Variable {
 				variable_names.add_string(name, name_len),
-				value
+				value,
+				variables,
 			});
 		}
 	}
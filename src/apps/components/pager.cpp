@@ -34,7 +34,7 @@ Pager::Pager(const char *text) : text(text), lines() {
 }
 
 void Pager::draw() const {
-	const auto _ = term::Backbuffer();
+	const auto _ = term::Backbuffer(term::Backbuffer::Init::Clear);
 
 	term::clear();
 	term::go_to(0, 0);
@@ -51,11 +51,7 @@ void Pager::draw() const {
 				vga::Color::Black
 			);
 
-			for (size_t i = 0; i < visual_lines_to_write; ++i) {
-				for (size_t j = 0; j < vga::WIDTH; ++j) {
-					term::putbyte(0xf9);
-				}
-			}
+			term::putbytes(0xf9, visual_lines_to_write*vga::WIDTH);
 
 			break;
 		}
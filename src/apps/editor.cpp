@@ -506,32 +506,32 @@ menu::Menu<List<File>::iterator> run_menu {
 };
 
 void File::draw() {
-	{
-		auto _ = term::Backbuffer();
-
-		term::clear();
-		term::go_to(0, 0);
-
-		Pos draw_from = screen_top;
-		for (size_t i = 0; i < vga::HEIGHT; ++i) {
-			if (draw_from.line >= lines.size()) break;
-			if (draw_from.col == 0) {
-				if (state.relative_line_numbers && draw_from.line != cursor.line) {
-					const size_t rel = draw_from.line < cursor.line
-						? cursor.line - draw_from.line
-						: draw_from.line - cursor.line
-					;
-					write_lineno(i, rel);
-				} else if (state.relative_line_numbers) {
-					write_lineno(i, draw_from.line+1, true);
-				} else {
-					write_lineno(i, draw_from.line+1);
-				}
+	// only the lines being edited change from one redraw to the next
+	term::begin_frame();
+
+	term::clear();
+	term::go_to(0, 0);
+
+	Pos draw_from = screen_top;
+	for (size_t i = 0; i < vga::HEIGHT; ++i) {
+		if (draw_from.line >= lines.size()) break;
+		if (draw_from.col == 0) {
+			if (state.relative_line_numbers && draw_from.line != cursor.line) {
+				const size_t rel = draw_from.line < cursor.line
+					? cursor.line - draw_from.line
+					: draw_from.line - cursor.line
+				;
+				write_lineno(i, rel);
+			} else if (state.relative_line_numbers) {
+				write_lineno(i, draw_from.line+1, true);
+			} else {
+				write_lineno(i, draw_from.line+1);
 			}
-			write_from(i, draw_from);
-			advance(draw_from);
 		}
+		write_from(i, draw_from);
+		advance(draw_from);
 	}
+	term::present();
 
 	const auto cursor_pos = find_screen_pos(cursor);
 	assert(cursor_pos.has);
@@ -3,6 +3,7 @@
 #include <stddef.h>
 #include <string.h>
 
+#include <sdk/memstats.hpp>
 #include <sdk/terminal.hpp>
 #include <sdk/util.hpp>
 
@@ -19,9 +20,11 @@
 #include "apps/uptime.hpp"
 #include "apps/calculator.hpp"
 #include "apps/pi.hpp"
+#include "apps/mem_inspector.hpp"
 #include "apps/queued_demo.hpp"
 #include "apps/callback_demo.hpp"
 #include "apps/ignore_demo.hpp"
+#include "apps/benchmark.hpp"
 
 using namespace term;
 using namespace sdk::util;
@@ -95,6 +98,23 @@ void pager_test() {
 	}
 }
 
+void heap_stats() {
+	clear();
+
+	sdk::memstats::print();
+
+	puts("");
+	puts("Press any key to return.");
+
+	for (;;) {
+		__asm__ volatile("hlt" ::: "memory");
+
+		while (!ps2::events.empty()) {
+			if (ps2::events.pop().type == ps2::EventType::Press) return;
+		}
+	}
+}
+
 using MainFn = void(*)();
 
 void run(MainFn fn) {
@@ -109,12 +129,15 @@ const List<menu::Entry<MainFn>> menu_entries({
 	{ "Uptime Tracker", run, uptime::main },
 	{ "PEDMAS Calculator", run, calculator::main },
 	{ "Calculate PI", run, pi::main },
+	{ "Memory Inspector", run, mem_inspector::main },
 });
 const List<menu::Entry<MainFn>> hidden_menu_entries({
 	{ "DEBUG: QueuedEventLoop Demo", run, queued_demo::main },
 	{ "DEBUG: CallbackEventLoop Demo", run, callback_demo::main },
 	{ "DEBUG: IgnoreEventLoop Demo", run, ignore_demo::main },
 	{ "DEBUG: Pager Test", run, pager_test },
+	{ "DEBUG: Benchmarks", run, benchmark::main },
+	{ "DEBUG: Heap Statistics", run, heap_stats },
 });
 
 }
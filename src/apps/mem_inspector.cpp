@@ -0,0 +1,319 @@
+#include "apps/mem_inspector.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sdk/eventloop.hpp>
+#include <sdk/memstats.hpp>
+
+#include "ps2.hpp"
+#include "vga.hpp"
+
+/*
+ * Shows the allocator's is_used bitmap as a 64x16 map, where each cell
+ * shows how much of the blocks it covers are in use.
+ *
+ * Only cells whose occupancy changed since the last frame get redrawn
+ * (and the same goes for the stats below the map), so it's cheap enough
+ * to leave running at frame rate.
+ */
+
+namespace mem_inspector {
+
+namespace {
+
+constexpr size_t MAP_WIDTH = 64;
+constexpr size_t MAP_HEIGHT = 16;
+constexpr size_t NUM_CELLS = MAP_WIDTH*MAP_HEIGHT;
+// the address labels go to the left of the map
+constexpr size_t LABEL_X = 1;
+constexpr size_t MAP_X = 12;
+constexpr size_t MAP_Y = 2;
+constexpr size_t STATS_Y = MAP_Y + MAP_HEIGHT + 1;
+// each zoom step makes the cells this many times smaller or larger
+constexpr size_t ZOOM_FACTOR = 16;
+
+// what a cell can show: nothing (past the end of the heap), free,
+// three shades of partially used, or full
+constexpr uint8_t LEVEL_NONE = 0;
+constexpr uint8_t LEVEL_FREE = 1;
+constexpr uint8_t LEVEL_FULL = 5;
+constexpr uint8_t NUM_LEVELS = 6;
+constexpr vga::entry_t level_entries[NUM_LEVELS] = {
+	vga::entry(' ', vga::entry_color(vga::Color::Black, vga::Color::Black)),
+	vga::entry('\xfa', vga::entry_color(vga::Color::DarkGrey, vga::Color::Black)),
+	vga::entry('\xb0', vga::entry_color(vga::Color::Green, vga::Color::Black)),
+	vga::entry('\xb1', vga::entry_color(vga::Color::LightGreen, vga::Color::Black)),
+	vga::entry('\xb2', vga::entry_color(vga::Color::LightBrown, vga::Color::Black)),
+	vga::entry('\xdb', vga::entry_color(vga::Color::LightRed, vga::Color::Black)),
+};
+// marks a cell as needing to be redrawn, whatever its level
+constexpr uint8_t NOT_SHOWN = 0xFF;
+
+struct State {
+	bool should_quit = false;
+
+	// the map shows cells of cell_blocks blocks each, from view_begin
+	size_t view_begin = 0;
+	size_t cell_blocks = 1;
+	size_t max_cell_blocks = 1;
+	size_t cursor = 0;
+
+	// what's currently on screen, so that only what changed gets drawn
+	uint8_t shown[NUM_CELLS];
+	bool labels_dirty = true;
+	sdk::memstats::Stats shown_stats {};
+	bool stats_dirty = true;
+	size_t shown_cursor_used = 0;
+};
+
+// all the blocks in the bitmap, including padding past the end of the heap
+inline size_t heap_blocks() {
+	return _mm_internals::num_words * _mm_internals::BITS_PER_WORD;
+}
+
+size_t count_used(size_t begin, size_t count) {
+	if (begin >= heap_blocks()) return 0;
+	if (begin + count > heap_blocks()) count = heap_blocks() - begin;
+
+	size_t res = 0;
+	_mm_internals::for_each_span_word(begin, count, [&res](size_t word, uint32_t mask) {
+		res += __builtin_popcount(_mm_internals::is_used[word] & mask);
+	});
+	return res;
+}
+
+uint8_t cell_level(const State &state, size_t cell) {
+	const size_t begin = state.view_begin + cell*state.cell_blocks;
+	if (begin >= heap_blocks()) return LEVEL_NONE;
+
+	const size_t used = count_used(begin, state.cell_blocks);
+	if (used == 0) return LEVEL_FREE;
+	if (used == state.cell_blocks) return LEVEL_FULL;
+	return LEVEL_FREE + 1 + used*(LEVEL_FULL - LEVEL_FREE - 1) / state.cell_blocks;
+}
+
+void invalidate(State &state) {
+	memset(state.shown, NOT_SHOWN, sizeof(state.shown));
+	state.labels_dirty = true;
+	state.stats_dirty = true;
+}
+
+// show cells of the given size, keeping `block` under the cursor
+void focus(State &state, size_t block, size_t cell_blocks) {
+	block -= block % cell_blocks;
+
+	size_t at = state.cursor;
+	if (block < at*cell_blocks) at = block / cell_blocks;
+
+	state.cell_blocks = cell_blocks;
+	state.view_begin = block - at*cell_blocks;
+	state.cursor = at;
+
+	invalidate(state);
+}
+
+inline size_t cursor_block(const State &state) {
+	return state.view_begin + state.cursor*state.cell_blocks;
+}
+
+void move_cursor(State &state, int dx, int dy) {
+	const size_t old_cursor = state.cursor;
+	size_t x = state.cursor % MAP_WIDTH;
+	size_t y = state.cursor / MAP_WIDTH;
+	const size_t row_blocks = MAP_WIDTH*state.cell_blocks;
+
+	if (dx < 0 && x > 0) --x;
+	if (dx > 0 && x < MAP_WIDTH-1) ++x;
+	if (dy < 0) {
+		if (y > 0) --y;
+		else if (state.view_begin >= row_blocks) {
+			// scroll the view up a row instead
+			state.view_begin -= row_blocks;
+			invalidate(state);
+		}
+	}
+	if (dy > 0) {
+		if (y < MAP_HEIGHT-1) ++y;
+		else if (state.view_begin + NUM_CELLS*state.cell_blocks < heap_blocks()) {
+			state.view_begin += row_blocks;
+			invalidate(state);
+		}
+	}
+
+	state.cursor = x + y*MAP_WIDTH;
+	state.shown[old_cursor] = NOT_SHOWN;
+	state.shown[state.cursor] = NOT_SHOWN;
+	state.stats_dirty = true;
+}
+
+void handle_key(State &state, ps2::Event event) {
+	if (event.type != ps2::EventType::Press && event.type != ps2::EventType::Bounce) return;
+
+	using namespace ps2;
+	switch (event.key) {
+		case KEY_Q:
+		case KEY_ESCAPE: {
+			state.should_quit = true;
+		} break;
+
+		case KEY_LEFT:
+		case KEY_H: move_cursor(state, -1, 0); break;
+		case KEY_DOWN:
+		case KEY_J: move_cursor(state, 0, 1); break;
+		case KEY_UP:
+		case KEY_K: move_cursor(state, 0, -1); break;
+		case KEY_RIGHT:
+		case KEY_L: move_cursor(state, 1, 0); break;
+
+		case KEY_ENTER:
+		case KEY_PLUS:
+		case KEY_EQUALS: {
+			if (state.cell_blocks == 1) break;
+			const size_t cell_blocks = state.cell_blocks > ZOOM_FACTOR
+				? state.cell_blocks / ZOOM_FACTOR
+				: 1;
+			focus(state, cursor_block(state), cell_blocks);
+		} break;
+		case KEY_MINUS:
+		case KEY_BACKSPACE: {
+			if (state.cell_blocks == state.max_cell_blocks) break;
+			const size_t cell_blocks = state.cell_blocks*ZOOM_FACTOR < state.max_cell_blocks
+				? state.cell_blocks * ZOOM_FACTOR
+				: state.max_cell_blocks;
+			focus(state, cursor_block(state), cell_blocks);
+		} break;
+
+		default: break;
+	}
+}
+
+void put_hex(uint32_t x, size_t col, size_t row, vga::entry_color_t color) {
+	for (size_t i = 0; i < 8; ++i) {
+		const uint8_t digit = (x >> (28 - 4*i)) & 0xF;
+		term::putbyteat(digit < 10 ? '0' + digit : 'a' - 10 + digit, color, col + i, row);
+	}
+}
+void clear_line(size_t row) {
+	for (size_t col = 0; col < vga::WIDTH; ++col) {
+		term::putbyteat(' ', term::getcolor(), col, row);
+	}
+	term::go_to(0, row);
+}
+
+inline uintptr_t block_addr(size_t block) {
+	return uintptr_t(_mm_internals::get_ptr(block));
+}
+
+void draw_labels(const State &state) {
+	const vga::entry_color_t color = vga::entry_color(vga::Color::DarkGrey, vga::Color::Black);
+
+	clear_line(0);
+	printf("MEMORY INSPECTOR  1 cell = %u KiB",
+		state.cell_blocks * _mm_internals::MIN_ALLOC_SIZE / 1024
+	);
+
+	for (size_t row = 0; row < MAP_HEIGHT; ++row) {
+		const size_t block = state.view_begin + row*MAP_WIDTH*state.cell_blocks;
+		term::putbyteat('0', color, LABEL_X, MAP_Y + row);
+		term::putbyteat('x', color, LABEL_X + 1, MAP_Y + row);
+		put_hex(block_addr(block), LABEL_X + 2, MAP_Y + row, color);
+	}
+
+	clear_line(STATS_Y + 4);
+	puts("arrows: move  enter/+: zoom in  backspace/-: zoom out  q/esc: quit");
+	clear_line(STATS_Y + 3);
+	printf("free \xfa  partly used \xb0\xb1\xb2  full \xdb");
+}
+
+bool stats_changed(const sdk::memstats::Stats &a, const sdk::memstats::Stats &b) {
+	return a.live != b.live || a.peak != b.peak
+		|| a.live_in_blocks != b.live_in_blocks
+		|| a.free != b.free || a.largest_free_run != b.largest_free_run;
+}
+
+void draw_stats(State &state) {
+	const auto stats = sdk::memstats::get();
+	const size_t used = count_used(cursor_block(state), state.cell_blocks);
+
+	if (!state.stats_dirty && !stats_changed(stats, state.shown_stats) && used == state.shown_cursor_used) {
+		return;
+	}
+	state.stats_dirty = false;
+	state.shown_stats = stats;
+	state.shown_cursor_used = used;
+
+	clear_line(STATS_Y);
+	printf("live: %u KiB (peak %u KiB), %u KiB in blocks (peak %u KiB)",
+		stats.live / 1024, stats.peak / 1024,
+		stats.live_in_blocks / 1024, stats.peak_in_blocks / 1024
+	);
+	clear_line(STATS_Y + 1);
+	printf("free: %u KiB of %u KiB, largest free run %u KiB, %u%% fragmented",
+		stats.free / 1024, stats.total / 1024,
+		stats.largest_free_run / 1024, stats.fragmentation
+	);
+	clear_line(STATS_Y + 2);
+	printf("cursor: %p, %u/%u blocks used",
+		(void*)block_addr(cursor_block(state)), used, state.cell_blocks
+	);
+}
+
+void draw(State &state) {
+	if (state.labels_dirty) {
+		draw_labels(state);
+		state.labels_dirty = false;
+	}
+
+	for (size_t cell = 0; cell < NUM_CELLS; ++cell) {
+		const uint8_t level = cell_level(state, cell);
+		if (level == state.shown[cell]) continue;
+		state.shown[cell] = level;
+
+		vga::entry_t entry = level_entries[level];
+		if (cell == state.cursor) {
+			// highlight the cursor by giving it a light background
+			entry = (entry & 0x0FFF) | (vga::entry_t(vga::Color::LightGrey) << 12);
+		}
+
+		term::putentryat(entry, MAP_X + cell%MAP_WIDTH, MAP_Y + cell/MAP_WIDTH);
+	}
+
+	draw_stats(state);
+}
+
+}
+
+void main() {
+	term::disable_autoscroll();
+	term::cursor::disable();
+	term::clear();
+
+	State state {};
+
+	// start zoomed all the way out, with the whole heap on screen
+	while (state.max_cell_blocks*NUM_CELLS < heap_blocks()) {
+		state.max_cell_blocks *= 2;
+	}
+	focus(state, 0, state.max_cell_blocks);
+
+	sdk::QueuedEventLoop event_loop {};
+
+	while (!state.should_quit) {
+		auto _ = event_loop.get_frame(33); // 30 fps
+
+		for (auto event : event_loop.events()) {
+			handle_key(state, event);
+		}
+
+		if (!state.should_quit) draw(state);
+	}
+
+	term::clear();
+	term::enable_autoscroll();
+}
+
+}
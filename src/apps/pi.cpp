@@ -5,6 +5,7 @@
 #include <stdio.h>
 
 #include <sdk/eventloop.hpp>
+#include <sdk/fmt.hpp>
 #include <sdk/random.hpp>
 #include <sdk/terminal.hpp>
 
@@ -54,38 +55,43 @@ void handle_keypress(State &state, ps2::Event event) {
 	}
 }
 
-void print_order(int n) {
-	if (n < 1000) {
-	} else if (n < 1000 * 1000) {
-		printf("(%sthousands)",
-			n < 10 * 1000 ? "" :
-			n < 100 * 1000 ? "tens of " :
-			"hundreds of "
-		);
-	} else if (n < 1000 * 1000 * 1000) {
-		printf("(%smillions)",
-			n < 10 * 1000 * 1000 ? "" :
-			n < 100 * 1000 * 1000 ? "tens of " :
-			"hundreds of "
-		);
-	} else {
-		printf("(billions)");
-	}
+// a count, followed by roughly how big it is, like "(tens of thousands)"
+struct Order {
+	int n;
+};
+
 }
 
-void print_double(double d) {
-	printf("%d.", (long long)d);
-	d -= (long long)d;
-	for (int i = 0; i < 6; ++i) {
-		d *= 10;
-		putchar('0' + (int)d);
-		d -= (int)d;
-	}
 }
 
-void draw(State &state) {
-	auto _ = term::Backbuffer();
+template<>
+struct sdk::fmt::Formatter<pi::Order> {
+	static constexpr bool accepts(const Spec &spec) {
+		return Formatter<int>::accepts(spec);
+	}
+	static void write(Writer &out, pi::Order order, const Spec &spec) {
+		const int n = order.n;
+		Formatter<int>::write(out, n, spec);
+		if (n < 1000) return;
+
+		const char *const units = n < 1000 * 1000 ? "thousands"
+			: n < 1000 * 1000 * 1000 ? "millions"
+			: "billions";
+		const int in_units = n < 1000 * 1000 ? n / 1000
+			: n < 1000 * 1000 * 1000 ? n / (1000 * 1000)
+			: n / (1000 * 1000 * 1000);
+		const char *const scale = in_units < 10 ? ""
+			: in_units < 100 ? "tens of "
+			: "hundreds of ";
+		format_to(out, SDK_FMT(" ({}{})"), scale, units);
+	}
+};
 
+namespace pi {
+
+namespace {
+
+void draw(State &state, term::FlipBuffer &screen) {
 	term::clear();
 
 	const char *title = "CALCULATING PI...";
@@ -97,62 +103,60 @@ void draw(State &state) {
 		term::writestring, title
 	);
 
+	using sdk::fmt::print;
+
 	term::go_to(1, 3);
-	printf("No of rounds completed: %d", state.rounds_complete);
+	print(SDK_FMT("No of rounds completed: {}"), state.rounds_complete);
 	if (state.rounds_complete) {
 		term::go_to(1, 5);
-		printf("Current avg. ratio of heads/total flips: ");
-		print_double(state.avg_ratio);
+		print(SDK_FMT("Current avg. ratio of heads/total flips: {:.6}"), state.avg_ratio);
 		term::go_to(3, 6);
-		printf("Current estimated value of pi: ");
-		print_double(state.avg_ratio*4);
+		print(SDK_FMT("Current estimated value of pi: {:.6}"), state.avg_ratio*4);
 	} else {
 		term::go_to(1, 5);
-		printf("Current avg. ratio of heads/total flips: -");
+		print(SDK_FMT("Current avg. ratio of heads/total flips: -"));
 		term::go_to(3, 6);
-		printf("Current estimated value of pi: -");
+		print(SDK_FMT("Current estimated value of pi: -"));
 	}
 	term::go_to(1, 7);
-	printf("Previous ratio of heads/total flips: ");
-	print_double(state.prev_ratio);
+	print(SDK_FMT("Previous ratio of heads/total flips: {:.6}"), state.prev_ratio);
 	term::go_to(1, 8);
-	printf("Previous estimated value of pi: ");
-	print_double(state.prev_ratio*4);
+	print(SDK_FMT("Previous estimated value of pi: {:.6}"), state.prev_ratio*4);
 
 	term::go_to(1, 10);
-	printf("Current run:");
+	print(SDK_FMT("Current run:"));
 	term::go_to(3, 11);
-	printf("Current no. of heads: %d ", state.curr_heads);
-	print_order(state.curr_heads);
+	print(SDK_FMT("Current no. of heads: {}"), Order { state.curr_heads });
 	term::go_to(3, 12);
-	printf("Current no. of tails: %d ", state.curr_tails);
-	print_order(state.curr_tails);
+	print(SDK_FMT("Current no. of tails: {}"), Order { state.curr_tails });
 	term::go_to(3, 13);
-	printf("Current heads/total: ");
 	if (state.curr_heads+state.curr_tails) {
-		print_double(state.curr_heads/(double)(state.curr_heads+state.curr_tails));
-	} else putchar('/');
+		print(SDK_FMT("Current heads/total: {:.6}"),
+			state.curr_heads/(double)(state.curr_heads+state.curr_tails)
+		);
+	} else {
+		print(SDK_FMT("Current heads/total: /"));
+	}
 
 	term::go_to(1, 15);
-	printf("Longest run so far: %d ", state.longest_run);
-	print_order(state.longest_run);
+	print(SDK_FMT("Longest run so far: {}"), Order { state.longest_run });
 	term::go_to(1, 16);
-	printf("Longest run of heads so far: %d ", state.longest_heads);
-	print_order(state.longest_heads);
+	print(SDK_FMT("Longest run of heads so far: {}"), Order { state.longest_heads });
 	term::go_to(1, 17);
-	printf("Longest run of tails so far: %d ", state.longest_tails);
-	print_order(state.longest_tails);
+	print(SDK_FMT("Longest run of tails so far: {}"), Order { state.longest_tails });
 	term::go_to(1, 18);
-	printf("Total number of coins flipped so far: %d ", state.total_flipped);
-	print_order(state.total_flipped);
+	print(SDK_FMT("Total number of coins flipped so far: {}"), Order { state.total_flipped });
 
 	term::go_to(1, 20);
-	printf("Number of truncated rounds: %d ", state.truncated_rounds);
-	print_order(state.truncated_rounds);
+	print(SDK_FMT("Number of truncated rounds: {}"), Order { state.truncated_rounds });
 	term::go_to(3, 21);
-	printf("(Once 2^28 coin flips has been reached, the ratio is approximated as 0.5)");
+	print(SDK_FMT("(Once 2^28 coin flips has been reached, the ratio is approximated as 0.5)"));
 
 	term::go_to(0, 0);
+
+	// the next frame is only drawn after flipping coins for 1/24s, by
+	// which time this one is long on the screen
+	screen.flip(false);
 }
 
 void tick(State &state) {
@@ -216,7 +220,8 @@ void main() {
 	//State state{};
 	state.should_quit = false;
 
-	draw(state);
+	term::FlipBuffer screen;
+	draw(state, screen);
 
 	while (!state.should_quit) {
 		tick(state);
@@ -229,7 +234,7 @@ void main() {
 			ps2::key_event_pending = false;
 		}
 
-		draw(state);
+		draw(state, screen);
 	}
 }
 
@@ -146,6 +146,8 @@ struct State {
 	Pos apple;
 	int score = 0;
 	uint32_t last_move_time = 0;
+	// the game redraws everything every frame anyway
+	term::FlipBuffer screen;
 };
 
 namespace help_menu {
@@ -172,9 +174,7 @@ void tick(State &state) {
 	}
 }
 
-void draw() {
-	auto _ = term::Backbuffer();
-
+void draw(State &state) {
 	term::clear();
 
 	const char *title = "HELP";
@@ -221,6 +221,8 @@ void draw() {
 			}
 		}
 	}
+
+	state.screen.flip();
 }
 
 }
@@ -286,8 +288,6 @@ void draw(State &state) {
 
 	cursor::disable();
 
-	auto _ = Backbuffer();
-
 	clear();
 
 	go_to(2, 1);
@@ -326,6 +326,8 @@ void draw(State &state) {
 		go_to(lose_text_offset, vga::HEIGHT/2 + 1);
 		writestring(frame_text);
 	}
+
+	state.screen.flip();
 }
 
 void update(State &state) {
@@ -427,7 +429,7 @@ void main() {
 			} else {
 				help_menu::tick(state);
 				if (!state.help_screen_drawn) {
-					help_menu::draw();
+					help_menu::draw(state);
 					state.help_screen_drawn = true;
 				}
 
@@ -3,6 +3,8 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <sdk/fmt.hpp>
+
 #include "pit.hpp"
 #include "ps2.hpp"
 #include "vga.hpp"
@@ -12,7 +14,7 @@ namespace uptime {
 namespace {
 
 void draw() {
-	const auto _ = term::Backbuffer();
+	const auto _ = term::Backbuffer(term::Backbuffer::Init::Clear);
 
 	const uint32_t now = pit::millis;
 
@@ -29,25 +31,14 @@ void draw() {
 	term::clear();
 	term::go_to(0, 0);
 
-	char time_display[] = "HH:MM:SS.MMM";
-
-	time_display[0] = '0' + hours/10;
-	time_display[1] = '0' + hours%10;
-
-	time_display[3] = '0' + minutes/10;
-	time_display[4] = '0' + minutes%10;
-
-	time_display[6] = '0' + seconds/10;
-	time_display[7] = '0' + seconds%10;
-
-	time_display[9] = '0' + millis/100;
-	time_display[10] = '0' + (millis/10)%10;
-	time_display[11] = '0' + millis%10;
-
 	if (days) {
-		printf("System Uptime: %u days, %s\n", days, time_display);
+		sdk::fmt::print(SDK_FMT("System Uptime: {} days, {:02}:{:02}:{:02}.{:03}\n"),
+			days, hours, minutes, seconds, millis
+		);
 	} else {
-		printf("System Uptime: %s\n", time_display);
+		sdk::fmt::print(SDK_FMT("System Uptime: {:02}:{:02}:{:02}.{:03}\n"),
+			hours, minutes, seconds, millis
+		);
 	}
 	puts("Press Q or ESC to quit.");
 }
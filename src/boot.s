@@ -32,6 +32,24 @@
  * will assume the stack is properly aligned and failure to align the stack
  * will result in undefined behaviour.
  */
+/*
+ * CPUID leaf 1's feature flags (edx), read while setting up the FPU below;
+ * see include/fpu.hpp
+ */
+.section .data
+.align 4
+.global fpu_cpu_features
+fpu_cpu_features: .long 0
+
+.set CR0_MP, 1<<1  /* wait/fwait respect the TS flag */
+.set CR0_EM, 1<<2  /* emulate the FPU (ie. trap on every FPU instruction) */
+.set CR0_TS, 1<<3  /* task switched (trap on the next FPU instruction) */
+.set CR0_NE, 1<<5  /* report FPU errors as exceptions, not via the PIC */
+.set CR4_OSFXSR,     1<<9  /* fxsave/fxrstor and SSE instructions */
+.set CR4_OSXMMEXCPT, 1<<10 /* report SSE errors as exceptions */
+.set CPUID_FXSR, 1<<24
+.set CPUID_SSE,  1<<25
+
 .section .bss
 .align 16
 stack_bottom:
@@ -55,14 +73,46 @@ _start:
 	mov $stack_top, %esp
 
 	/*
-	 * note: features like floating point instructions and instruction set
-	 * extensions are not initialised yet. gdt should in theory be loaded
-	 * here, but if I build a single monolithic executable I don't think
-	 * that's necessary. similar for paging.
+	 * set up the x87 FPU (and SSE, if there is any) before any C++ runs,
+	 * since the compiler is free to use them (especially when building
+	 * with SSE=1). This assumes at least a Pentium Pro, since that's what
+	 * the compiler targets anyways, so CPUID and the FPU are there.
+	 */
+	mov %cr0, %eax
+	and $~(CR0_EM | CR0_TS), %eax
+	or $(CR0_MP | CR0_NE), %eax
+	mov %eax, %cr0
+	fninit
+
+	mov $1, %eax
+	cpuid
+	mov %edx, fpu_cpu_features
+
+	and $(CPUID_FXSR | CPUID_SSE), %edx
+	cmp $(CPUID_FXSR | CPUID_SSE), %edx
+	jne 1f
+	mov %cr4, %eax
+	or $(CR4_OSFXSR | CR4_OSXMMEXCPT), %eax
+	mov %eax, %cr4
+1:
+
+	/*
+	 * note: gdt should in theory be loaded here, but if I build a single
+	 * monolithic executable I don't think that's necessary. similar for
+	 * paging.
 	 */
 
-	/* this function should set up the absolute bare essentials */
+	/*
+	 * this function should set up the absolute bare essentials.
+	 * The bootloader leaves the multiboot magic number in eax and a
+	 * pointer to the multiboot info structure in ebx, so pass those
+	 * along (pad to keep the stack 16-byte aligned at the call)
+	 */
+	sub $8, %esp
+	push %ebx
+	push %eax
 	call kernel_early_main
+	add $16, %esp
 
 	/* run global initialisers */
 	call _init
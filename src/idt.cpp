@@ -59,7 +59,7 @@ void init() {
 	idt[0x04] = IDT_TRP(isr0x04_OF);
 	idt[0x05] = IDT_FLT(isr0x05_BR);
 	idt[0x06] = IDT_FLT(isr0x06_UD);
-	idt[0x07] = IDT_FLT(isr0x07_NM);
+	idt[0x07] = IDT_INT(isr0x07_NM); // saves FPU state, mustn't be interrupted
 	idt[0x08] = IDT_INT(isr0x08_DF); // ABORT
 	idt[0x0A] = IDT_FLT(isr0x0A_TS);
 	idt[0x0B] = IDT_FLT(isr0x0B_NP);
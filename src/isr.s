@@ -29,6 +29,57 @@
 	iret
 .endm
 
+/*
+ * The FPU is handed over to IRQ handlers lazily: on the way in, CR0.TS is set
+ * so that the first FPU/SSE instruction the handler uses raises #NM (see
+ * isr0x07_NM below), which saves the interrupted code's FPU state to a save
+ * area on the stack. On the way out, it's restored only if it was saved.
+ * Handlers which don't touch the FPU don't pay anything for it.
+ * These have to come after pushal, since they clobber eax, ebx and ebp.
+ */
+.set CR0_TS, 1<<3
+.set CPUID_FXSR, 1<<24
+.set CPUID_SSE, 1<<25
+.set FPU_SAVE_SIZE, 512 /* enough for fxsave, and fsave needs less */
+
+.macro irq_fpu_enter
+	mov %esp, %ebp
+	sub $FPU_SAVE_SIZE, %esp
+	and $-16, %esp /* fxsave needs the area to be 16-byte aligned */
+	mov %esp, %ebx
+
+	/* IRQs can interrupt each other, so keep the outer one's state */
+	pushl fpu_save_area
+	pushl fpu_state_saved
+	push %ebp
+	mov %cr0, %eax
+	push %eax
+
+	mov %ebx, fpu_save_area
+	movl $0, fpu_state_saved
+	or $CR0_TS, %eax
+	mov %eax, %cr0
+	/* pushed 16 bytes since aligning, so the stack's still aligned */
+.endm
+
+.macro irq_fpu_exit
+	pop %eax
+	cmpl $0, fpu_state_saved
+	je 1f
+	mov fpu_save_area, %ebx
+	testl $CPUID_FXSR, fpu_cpu_features
+	jz 2f
+	fxrstor (%ebx)
+	jmp 1f
+2:	frstor (%ebx)
+1:
+	mov %eax, %cr0 /* puts TS back the way it was */
+	pop %ebp
+	popl fpu_state_saved
+	popl fpu_save_area
+	mov %ebp, %esp
+.endm
+
 .macro isr_stub_err isr_name
 .global \isr_name
 \isr_name:
@@ -81,7 +132,46 @@ isr_stub_noerr isr0x06_UD /* undefined opcode */
 1: .ascii "Hit undefined opcode fault"
 2:
 
-isr_stub_noerr isr0x07_NM /* no math coprocessor */
+.global isr0x07_NM /* no math coprocessor */
+isr0x07_NM:
+	/* only expected from an IRQ handler using the FPU, see irq_fpu_enter */
+	cmpl $0, fpu_save_area
+	je 3f
+
+	push %eax
+	clts
+	mov fpu_save_area, %eax
+	testl $CPUID_FXSR, fpu_cpu_features
+	jz 4f
+	fxsave (%eax)
+	/*
+	 * the handler gets a clean FPU rather than the interrupted code's
+	 * control word and MXCSR (rounding mode, exception masks): fxsave
+	 * leaves them as they were, unlike fnsave, which reinitialises the
+	 * FPU itself. MXCSR only exists (and SSE is only enabled) if there's
+	 * SSE as well, see boot.s
+	 */
+	fninit
+	mov fpu_cpu_features, %eax
+	and $(CPUID_FXSR | CPUID_SSE), %eax
+	cmp $(CPUID_FXSR | CPUID_SSE), %eax
+	jne 5f
+	ldmxcsr default_mxcsr
+	jmp 5f
+4:	fnsave (%eax)
+5:	movl $1, fpu_state_saved
+	pop %eax
+	iret
+
+3:	pushal
+
+	write_msg 1f, 2f
+	call blt_newline
+
+	call abort
+
+	popal
+	iret
 1: .ascii "Hit no math coprocessor fault"
 2:
 
@@ -174,8 +264,10 @@ isr_stub_noerr isr0x1F_CPU
 .global isr0x20_IRQ /* PIT timer triggers */
 isr0x20_IRQ:
 	pushal
-
+	cld /* the interrupted code might be copying backwards */
+	irq_fpu_enter
 	call pit_handle_trigger
+	irq_fpu_exit
 
 	mov $0x20, %al
 	outb %al, $0x20 /* send EOI to the pic */
@@ -187,7 +279,9 @@ isr0x20_IRQ:
 isr0x21_IRQ:
 	pushal
 	cld
+	irq_fpu_enter
 	call keyboard_interrupt_handler
+	irq_fpu_exit
 	popal
 	iret
 
@@ -210,5 +304,16 @@ isr_stub_noerr isr0x2F_IRQ
 2:
 
 error_code: .word 0
+
+.section .data
+.align 4
+/* where the current IRQ handler saves the FPU state, 0 outside of IRQs */
+fpu_save_area: .long 0
+/* whether the FPU state has been saved there */
+fpu_state_saved: .long 0
+/* MXCSR after reset: all exceptions masked, round to nearest */
+default_mxcsr: .long 0x1F80
+
+.section .text
 error_code_msg: .ascii "Error code: "
 error_code_msg_end:
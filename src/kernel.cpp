@@ -21,14 +21,18 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "fpu.hpp"
 #include "idt.hpp"
 #include "vga.hpp"
 #include "pic.hpp"
 #include "pit.hpp"
 #include "ps2.hpp"
+#include "serial.hpp"
 #include "ioport.hpp"
 #include "gdt.hpp"
+#include "multiboot.hpp"
 
 #include "apps/main_menu.hpp"
 
@@ -48,14 +52,32 @@
  * this way I know how to call it from assembly
  */
 /* also, to avoid name mangling */
-extern "C" void kernel_early_main(void);
+extern "C" void kernel_early_main(uint32_t multiboot_magic, const multiboot::info_t *multiboot_info);
 extern "C" void kernel_main(void);
 
-void kernel_early_main() {
+void kernel_early_main(uint32_t multiboot_magic, const multiboot::info_t *multiboot_info) {
 	__asm__ volatile("cli" ::: "memory");
 
 	/* Initialize terminal interface */
 	term::init();
+	/* and COM1, for stdserial (writes are dropped if there isn't one) */
+	serial::init();
+
+#ifdef __SSE2__
+	/* hopefully nothing's used SSE2 yet... */
+	if (!fpu::has(fpu::FEATURE_SSE2)) {
+		puts("kernel: panic: built with SSE=1, but the CPU doesn't have SSE2!");
+		abort();
+	}
+#endif
+
+	/* pick the SSE2 versions of strlen & co. if the CPU has SSE2 */
+	_string_internals::init();
+
+	/* Memory allocator bookkeeping (needed before anything is malloc'd) */
+	_mm_internals::mem_range_t usable[multiboot::MAX_RANGES];
+	const size_t num_usable = multiboot::usable_memory(multiboot_magic, multiboot_info, usable);
+	_mm_internals::init(usable, num_usable);
 
 	/* Global Descriptor Table (needed for the IDT) */
 	gdt::init();
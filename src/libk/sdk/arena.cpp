@@ -0,0 +1,86 @@
+#include <sdk/arena.hpp>
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace sdk {
+
+Arena::Arena(size_t chunk_size) : chunk_size(chunk_size) {
+	assert(chunk_size != 0);
+}
+Arena::~Arena() {
+	while (curr) {
+		Chunk *prev = curr->prev;
+		free(curr);
+		curr = prev;
+	}
+}
+
+void Arena::add_chunk(size_t min_size) {
+	// chunks are all the same size (unless an allocation doesn't fit),
+	// growing them would make an arena that overflows its first chunk
+	// every frame take a bigger chunk every frame, without bound
+	const size_t size = min_size > chunk_size ? min_size : chunk_size;
+
+	Chunk *chunk = (Chunk*)malloc(sizeof(Chunk) + size);
+	assert(chunk != NULL);
+	chunk->prev = curr;
+	chunk->size = size;
+
+	curr = chunk;
+	top = 0;
+}
+
+void *Arena::alloc(size_t size, size_t align) {
+	assert(align != 0 && (align & (align-1)) == 0);
+
+	uintptr_t at = 0;
+	if (curr) {
+		at = ((uintptr_t)curr->data() + top + align-1) & ~(uintptr_t)(align-1);
+	}
+	if (curr == nullptr || at + size > (uintptr_t)curr->data() + curr->size) {
+		add_chunk(size + align-1);
+		at = ((uintptr_t)curr->data() + align-1) & ~(uintptr_t)(align-1);
+	}
+
+	top = at + size - (uintptr_t)curr->data();
+
+	return (void*)at;
+}
+
+void *Arena::resize(void *p, size_t old_size, size_t new_size, size_t align) {
+	if (p == nullptr) return alloc(new_size, align);
+
+	// the most recent allocation can just have its end moved
+	if (curr && (uint8_t*)p + old_size == curr->data() + top
+		&& (uint8_t*)p + new_size <= curr->data() + curr->size
+	) {
+		top = (uint8_t*)p + new_size - curr->data();
+		return p;
+	}
+
+	void *res = alloc(new_size, align);
+	memcpy(res, p, old_size < new_size ? old_size : new_size);
+	return res;
+}
+
+void Arena::reset(Mark mark) {
+	// keep the first chunk around, rather than freeing it and taking
+	// it from the heap again every time the arena is emptied
+	if (mark.chunk == nullptr && curr && curr->prev == nullptr) {
+		top = 0;
+		return;
+	}
+
+	while (curr != mark.chunk) {
+		assert(curr != nullptr);
+
+		Chunk *prev = curr->prev;
+		free(curr);
+		curr = prev;
+	}
+	top = mark.top;
+}
+
+}
@@ -13,18 +13,31 @@ Frame EventLoop::get_frame(uint32_t frame_length_ms) {
 }
 
 namespace {
+// blocks to zero at a time while waiting for the frame to end;
+// small enough to not overshoot the frame by much
+constexpr size_t IDLE_ZERO_BLOCKS = 16;
+
 void eventloop_poll_wrapper(void *eventloop) {
 	static_cast<EventLoop*>(eventloop)->poll();
 }
 }
 
 Frame::Frame(EventLoop &owner, uint32_t frame_length)
-: owner(owner), frame_end(pit::millis + frame_length)
+: owner(owner), frame_end(pit::millis + frame_length), scratch_mark(owner.scratch_arena.mark())
 {
 	owner.frame_startup();
 }
 Frame::~Frame() {
 	owner.frame_teardown();
+
+	owner.scratch_arena.reset(scratch_mark);
+
+	// use whatever is left of the frame to clear freed memory,
+	// so that it doesn't have to be done when it's calloc'd again
+	while (pit::millis < frame_end) {
+		if (_mm_internals::zero_free_blocks(IDLE_ZERO_BLOCKS) == 0) break;
+	}
+
 	pit::sleep_until<true>(frame_end, eventloop_poll_wrapper, &owner);
 }
 
@@ -0,0 +1,151 @@
+#include <sdk/fmt.hpp>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vga.hpp"
+
+namespace sdk::fmt {
+
+void Writer::fill(char c, size_t count) {
+	char chunk[16];
+	memset(chunk, c, count < sizeof(chunk) ? count : sizeof(chunk));
+
+	while (count) {
+		const size_t amount = count < sizeof(chunk) ? count : sizeof(chunk);
+		write(chunk, amount);
+		count -= amount;
+	}
+}
+
+BufferWriter::BufferWriter(char *buf, size_t size) : buf(buf), size(size) {
+	if (size) buf[0] = 0;
+}
+void BufferWriter::write(const char *data, size_t len) {
+	wanted += len;
+	if (size == 0) return;
+
+	const size_t room = size-1 - this->len;
+	const size_t amount = len < room ? len : room;
+	memcpy(&buf[this->len], data, amount);
+	this->len += amount;
+	buf[this->len] = 0;
+}
+
+void StringWriter::write(const char *data, size_t len) {
+	str.append(data, len);
+}
+
+TerminalWriter::~TerminalWriter() {
+	flush();
+}
+void TerminalWriter::write(const char *data, size_t len) {
+	if (this->len + len > sizeof(buf)) flush();
+
+	if (len >= sizeof(buf)) {
+		term::write(data, len);
+	} else {
+		memcpy(&buf[this->len], data, len);
+		this->len += len;
+	}
+}
+void TerminalWriter::flush() {
+	if (len) term::write(buf, len);
+	len = 0;
+}
+
+namespace {
+
+// writes sign (if any) and body, padded out to the spec's width
+void write_padded(Writer &out, char sign, const char *body, size_t len, const Spec &spec) {
+	const size_t total = len + (sign != 0);
+	const size_t padding = spec.width > total ? spec.width - total : 0;
+
+	if (spec.left) {
+		if (sign) out.write(&sign, 1);
+		out.write(body, len);
+		out.fill(' ', padding);
+	} else if (spec.zero_pad) {
+		if (sign) out.write(&sign, 1);
+		out.fill('0', padding);
+		out.write(body, len);
+	} else {
+		out.fill(' ', padding);
+		if (sign) out.write(&sign, 1);
+		out.write(body, len);
+	}
+}
+
+size_t to_hex(char *buf_end, uint64_t x) {
+	size_t len = 0;
+	do {
+		const uint8_t digit = x&0xF;
+		buf_end[-++len] = digit < 10 ? '0' + digit : 'a' - 10 + digit;
+		x >>= 4;
+	} while (x > 0);
+	return len;
+}
+
+}
+
+void write_str(Writer &out, const char *str, size_t len, const Spec &spec) {
+	if (spec.precision >= 0 && size_t(spec.precision) < len) len = spec.precision;
+	write_padded(out, 0, str, len, spec);
+}
+
+void write_int(Writer &out, uint64_t magnitude, bool negative, const Spec &spec) {
+	char buf[UTOA64_MAX];
+	if (spec.hex) {
+		char *const end = buf + sizeof(buf);
+		const size_t len = to_hex(end, magnitude);
+		write_padded(out, negative ? '-' : 0, end - len, len, spec);
+	} else {
+		write_padded(out, negative ? '-' : 0, buf, utoa64(magnitude, buf), spec);
+	}
+}
+
+void write_double(Writer &out, double d, const Spec &spec) {
+	char buf[DTOA_MAX + DTOA_FIXED_MAX_PRECISION];
+	const size_t len = spec.precision < 0
+		? dtoa(d, buf)
+		: dtoa_fixed(d, spec.precision, buf);
+
+	// the sign goes before any zero padding
+	if (buf[0] == '-') write_padded(out, '-', buf+1, len-1, spec);
+	else write_padded(out, 0, buf, len, spec);
+}
+
+void write_pointer(Writer &out, const void *p, const Spec &spec) {
+	char buf[2 + 2*sizeof(uintptr_t)];
+	char *const end = buf + sizeof(buf);
+
+	// always all the digits
+	memset(buf, '0', sizeof(buf));
+	to_hex(end, (uintptr_t)p);
+	buf[1] = 'x';
+
+	write_padded(out, 0, buf, sizeof(buf), spec);
+}
+
+void Formatter<const char*>::write(Writer &out, const char *value, const Spec &spec) {
+	write_str(out, value, strlen(value), spec);
+}
+
+namespace detail {
+
+void vformat(Writer &out, const Segment *segments, size_t num_segments, const Arg *args) {
+	for (size_t i = 0; i < num_segments; ++i) {
+		const Segment &seg = segments[i];
+		if (seg.is_arg) {
+			args->write(out, args->value, seg.spec);
+			++args;
+		} else {
+			out.write(seg.text, seg.len);
+		}
+	}
+}
+
+}
+
+}
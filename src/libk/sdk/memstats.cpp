@@ -0,0 +1,118 @@
+#include <sdk/memstats.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace sdk::memstats {
+
+Stats get() {
+	using namespace _mm_internals;
+
+	Stats res;
+
+	res.total = stats.total_blocks * MIN_ALLOC_SIZE;
+	res.live = stats.live_bytes;
+	res.peak = stats.peak_bytes;
+	res.live_in_blocks = stats.live_blocks * MIN_ALLOC_SIZE;
+	res.peak_in_blocks = stats.peak_blocks * MIN_ALLOC_SIZE;
+	res.free = (stats.total_blocks - stats.live_blocks) * MIN_ALLOC_SIZE;
+	res.largest_free_run = largest_free_run() * MIN_ALLOC_SIZE;
+
+	res.allocs = stats.num_allocs;
+	res.frees = stats.num_frees;
+	res.reallocs_in_place = stats.reallocs_in_place;
+	res.reallocs_copied = stats.reallocs_copied;
+	res.zeroing_skipped = stats.zeroing_skipped;
+
+	res.fragmentation = res.free
+		? 100 - uint32_t(uint64_t(res.largest_free_run) * 100 / res.free)
+		: 0;
+
+	return res;
+}
+
+size_t num_buckets() {
+	return _mm_internals::NUM_SIZE_BUCKETS;
+}
+size_t bucket_limit(size_t bucket) {
+	return size_t(8) << bucket;
+}
+size_t bucket_allocs(size_t bucket) {
+	return _mm_internals::stats.size_buckets[bucket];
+}
+
+bool tracing_callers() {
+#ifdef MM_TRACE_CALLERS
+	return true;
+#else
+	return false;
+#endif
+}
+size_t top_callers(Caller *out, size_t max) {
+	size_t count = 0;
+
+#ifdef MM_TRACE_CALLERS
+	// insertion sort into out, dropping whatever falls off the end
+	for (const auto &entry : _mm_internals::callers) {
+		if (entry.addr == nullptr) continue;
+
+		size_t at = count;
+		while (at > 0 && out[at-1].bytes < entry.bytes) --at;
+		if (at == max) continue;
+
+		const size_t last = count < max ? count : max-1;
+		for (size_t i = last; i > at; --i) out[i] = out[i-1];
+		out[at] = { entry.addr, entry.allocs, entry.bytes };
+
+		if (count < max) ++count;
+	}
+#else
+	(void)out;
+	(void)max;
+#endif
+
+	return count;
+}
+
+void print() {
+	const Stats stats = get();
+
+	printf("heap: %u KiB live (%u KiB in blocks), %u KiB peak, %u KiB total\n",
+		stats.live / 1024, stats.live_in_blocks / 1024,
+		stats.peak / 1024, stats.total / 1024
+	);
+	printf("free: %u KiB, largest run %u KiB, %u%% fragmented\n",
+		stats.free / 1024, stats.largest_free_run / 1024,
+		stats.fragmentation
+	);
+	printf("%u allocs, %u frees, %u reallocs in place, %u copied\n",
+		stats.allocs, stats.frees,
+		stats.reallocs_in_place, stats.reallocs_copied
+	);
+	printf("%u KiB calloc'd without needing to be cleared\n",
+		stats.zeroing_skipped / 1024
+	);
+
+	puts("allocations by size:");
+	for (size_t i = 0; i < num_buckets(); ++i) {
+		if (bucket_allocs(i) == 0) continue;
+
+		if (i+1 == num_buckets()) printf("  >%u: %u\n", bucket_limit(i-1), bucket_allocs(i));
+		else printf("  <=%u: %u\n", bucket_limit(i), bucket_allocs(i));
+	}
+
+	if (!tracing_callers()) return;
+
+	constexpr size_t TOP_CALLERS = 8;
+	Caller callers[TOP_CALLERS];
+	const size_t num_callers = top_callers(callers, TOP_CALLERS);
+
+	puts("heaviest callers:");
+	for (size_t i = 0; i < num_callers; ++i) {
+		printf("  %p: %u allocs, %u KiB\n",
+			callers[i].addr, callers[i].allocs, callers[i].bytes / 1024
+		);
+	}
+}
+
+}
@@ -4,7 +4,30 @@
 
 namespace sdk::util {
 
+char *String::alloc_buf(size_t capacity, Arena *arena) {
+	if (arena) return (char*)arena->alloc(capacity, 1);
+	return (char*)calloc(capacity, sizeof(char));
+}
+void String::free_buf() {
+	// arena memory is only given back when the arena is reset
+	if (!arena) free(buf);
+}
+
 void String::grow_cap() {
+	if (arena) {
+		const size_t new_cap = cap ? cap*2 : 64;
+		buf = (char*)arena->resize(buf, cap, new_cap, 1);
+		cap = new_cap;
+		return;
+	}
+
+	// use up the slack the allocator gave us before asking for more
+	const size_t usable = malloc_usable_size(buf);
+	if (usable > cap) {
+		cap = usable;
+		return;
+	}
+
 	cap *= 2;
 	if (cap == 0) cap = 64;
 	buf = (char*)realloc(buf, cap);
@@ -115,7 +138,7 @@ String String::substr(size_t first, size_t last) {
 	assert(first <= len);
 	assert(last <= len);
 	assert(first < last);
-	return String(&buf[first], last-first);
+	return String(&buf[first], last-first, arena);
 }
 String String::substr(iterator first, iterator last) {
 	return substr(first - begin(), last - begin());
@@ -127,6 +150,13 @@ String String::substr(iterator first) {
 	return substr(first - begin());
 }
 
+String &String::append(const char *str, size_t len) {
+	for (size_t i = 0; i < len; ++i) {
+		add_char_unsafe(str[i]);
+	}
+	add_null_terminator();
+	return *this;
+}
 String &String::operator+=(char c) {
 	add_char_unsafe(c);
 	add_null_terminator();
@@ -147,17 +177,17 @@ String &String::operator+=(const String &other) {
 	return *this;
 }
 String String::operator+(char c) const {
-	String res(*this);
+	String res(*this, arena);
 	res += c;
 	return res;
 }
 String String::operator+(const char *str) const {
-	String res(*this);
+	String res(*this, arena);
 	res += str;
 	return res;
 }
 String String::operator+(const String &other) const {
-	String res(*this);
+	String res(*this, arena);
 	res += other;
 	return res;
 }
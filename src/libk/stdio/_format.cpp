@@ -0,0 +1,197 @@
+#include <stdio.h>
+
+#include <stdarg.h>
+#include <stdint.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace _stdio_internals {
+
+void flush(sink_t &sink) {
+	if (sink.flush && sink.len) sink.flush(sink.ctx, sink.buf, sink.len);
+	sink.len = 0;
+}
+
+void put(sink_t &sink, const char *data, size_t len) {
+	sink.total += len;
+
+	// too big to be worth buffering, so write it out directly
+	if (sink.flush && len >= sink.size) {
+		flush(sink);
+		sink.flush(sink.ctx, data, len);
+		return;
+	}
+
+	while (len) {
+		if (sink.len == sink.size) {
+			if (!sink.flush) return;
+			flush(sink);
+		}
+
+		const size_t room = sink.size - sink.len;
+		const size_t amount = len < room ? len : room;
+		memcpy(&sink.buf[sink.len], data, amount);
+		sink.len += amount;
+		data += amount;
+		len -= amount;
+	}
+}
+void put(sink_t &sink, char c) {
+	++sink.total;
+
+	if (sink.len == sink.size) {
+		if (!sink.flush) return;
+		flush(sink);
+	}
+	sink.buf[sink.len++] = c;
+}
+
+namespace {
+
+void put_uint(sink_t &sink, uint64_t u) {
+	char buf[UTOA64_MAX];
+	put(sink, buf, utoa64(u, buf));
+}
+void put_int(sink_t &sink, int64_t d) {
+	if (d < 0) {
+		put(sink, '-');
+		// also works for -2^63, which has no positive int64_t
+		put_uint(sink, ~uint64_t(d) + 1);
+	} else {
+		put_uint(sink, d);
+	}
+}
+void put_hex(sink_t &sink, uint64_t x) {
+	/* max int is 2^64-1 = 16^16-1, so no more than 16 digits */
+	char buf[16];
+	size_t len = 0;
+
+	do {
+		const uint8_t digit = x&0xF;
+
+		if (digit < 10) buf[sizeof(buf) - ++len] = '0' + digit;
+		else buf[sizeof(buf) - ++len] = 'a' - 10 + digit;
+
+		x >>= 4;
+	} while (x > 0);
+
+	put(sink, &buf[sizeof(buf) - len], len);
+}
+void put_double(sink_t &sink, double d, int precision) {
+	char buf[DTOA_MAX + DTOA_FIXED_MAX_PRECISION];
+	put(sink, buf, dtoa_fixed(d, precision, buf));
+}
+void put_pointer(sink_t &sink, void *p) {
+	uint32_t x = (uintptr_t)p;
+
+	/* max int is 2^32-1 = 16^8-1, so 8 digits */
+	char buf[10] = { '0', 'x' };
+
+	for (size_t len = 1; len <= 8; ++len) {
+		const uint8_t digit = x&0xF;
+
+		if (digit < 10) buf[sizeof(buf)-len] = '0' + digit;
+		else buf[sizeof(buf)-len] = 'a' - 10 + digit;
+
+		x >>= 4;
+	}
+
+	put(sink, buf, sizeof(buf));
+}
+
+}
+
+int format(sink_t &sink, const char *__restrict format, va_list parameters) {
+	/*
+	 * the parsing was originally from https://wiki.osdev.org/Meaty_Skeleton,
+	 * but now everything goes into the sink instead of straight to the
+	 * terminal
+	 */
+	const size_t total_before = sink.total;
+
+	while (*format != '\0') {
+		// no format specifier, incl escaped '%'
+		if (format[0] != '%' || format[1] == '%') {
+			if (format[0] == '%') ++format;
+
+			size_t amount = 1;
+			while (format[amount] && format[amount] != '%') ++amount;
+
+			put(sink, format, amount);
+
+			format += amount;
+			continue;
+		}
+
+		const char *const format_begun_at = format++;
+
+		// only used by %f, which defaults to 6 digits like the real printf
+		int precision = 6;
+		if (*format == '.') {
+			++format;
+			precision = 0;
+			while ('0' <= *format && *format <= '9') {
+				precision = precision*10 + (*format++ - '0');
+			}
+		}
+
+		// %ld and %lld, and the same for u and x
+		enum { NORMAL, LONG, LONG_LONG } length = NORMAL;
+		if (format[0] == 'l' && format[1] == 'l') {
+			length = LONG_LONG;
+			format += 2;
+		} else if (format[0] == 'l') {
+			length = LONG;
+			++format;
+		}
+
+		if (*format == 'c') {
+			++format;
+
+			put(sink, (char)va_arg(parameters, int /* char promotes to an int, for some reason?? */));
+		} else if (*format == 's') {
+			++format;
+
+			const char *const str = va_arg(parameters, const char *);
+			put(sink, str, strlen(str));
+		} else if (*format == 'u' || *format == 'x') {
+			const uint64_t u = length == LONG_LONG ? va_arg(parameters, unsigned long long)
+				: length == LONG ? va_arg(parameters, unsigned long)
+				: va_arg(parameters, unsigned int);
+
+			if (*format++ == 'u') put_uint(sink, u);
+			else put_hex(sink, u);
+		} else if (*format == 'd') {
+			++format;
+
+			put_int(sink, length == LONG_LONG ? va_arg(parameters, long long)
+				: length == LONG ? va_arg(parameters, long)
+				: va_arg(parameters, int)
+			);
+		} else if (*format == 'f') {
+			++format;
+
+			// floats are promoted to doubles, like chars to ints
+			put_double(sink, va_arg(parameters, double), precision);
+		} else if (*format == 'p') {
+			++format;
+
+			put_pointer(sink, va_arg(parameters, void*));
+		} else {
+			// if unknown format specifier, seems we just give up?
+
+			format = format_begun_at;
+
+			const size_t len = strlen(format);
+			put(sink, format, len);
+			format += len;
+		}
+	}
+
+	const size_t written = sink.total - total_before;
+	if (written > __INT_MAX__) return -1; // overflow
+	return written;
+}
+
+}
@@ -0,0 +1,96 @@
+#include <stdio.h>
+
+#include <string.h>
+
+#include "serial.hpp"
+#include "vga.hpp"
+
+namespace _stdio_internals {
+
+char ring_log[RING_LOG_SIZE];
+size_t ring_log_total = 0;
+
+void write_direct(FILE *stream, const char *data, size_t len) {
+	if (stream->write(stream->ctx, data, len) < len) stream->error = true;
+}
+
+void write(FILE *stream, const char *data, size_t len) {
+	if (stream->mode == _IONBF || stream->size == 0) {
+		write_direct(stream, data, len);
+		return;
+	}
+
+	if (stream->len + len > stream->size) flush(stream);
+	if (len >= stream->size) {
+		// too big to be worth buffering
+		write_direct(stream, data, len);
+	} else {
+		memcpy(&stream->buf[stream->len], data, len);
+		stream->len += len;
+	}
+
+	flush_lines(stream);
+}
+
+void flush(FILE *stream) {
+	if (stream->len) write_direct(stream, stream->buf, stream->len);
+	stream->len = 0;
+}
+
+void flush_lines(FILE *stream) {
+	if (stream->mode == _IOLBF && memchr(stream->buf, '\n', stream->len)) {
+		flush(stream);
+	}
+}
+
+}
+
+using namespace _stdio_internals;
+
+namespace {
+
+size_t terminal_write(void *, const char *data, size_t len) {
+	term::write(data, len);
+	return len;
+}
+
+size_t serial_write(void *, const char *data, size_t len) {
+	serial::write(data, len);
+	return len;
+}
+
+size_t ring_write(void *, const char *data, size_t len) {
+	const size_t res = len;
+
+	// only the last RING_LOG_SIZE bytes can be kept anyway
+	if (len > RING_LOG_SIZE) {
+		ring_log_total += len - RING_LOG_SIZE;
+		data += len - RING_LOG_SIZE;
+		len = RING_LOG_SIZE;
+	}
+
+	// RING_LOG_SIZE is a power of two, so this stays right even when
+	// ring_log_total overflows
+	const size_t pos = ring_log_total % RING_LOG_SIZE;
+	const size_t first = len < RING_LOG_SIZE - pos ? len : RING_LOG_SIZE - pos;
+	memcpy(&ring_log[pos], data, first);
+	memcpy(&ring_log[0], data + first, len - first);
+	ring_log_total += len;
+
+	return res;
+}
+
+char serial_buf[256];
+
+FILE terminal_out = { terminal_write, nullptr, nullptr, 0, 0, _IONBF, false };
+FILE terminal_err = { terminal_write, nullptr, nullptr, 0, 0, _IONBF, false };
+FILE serial_out = { serial_write, nullptr, serial_buf, sizeof(serial_buf), 0, _IOLBF, false };
+// copying into the ring is as cheap as copying into a buffer
+FILE ring_out = { ring_write, nullptr, nullptr, 0, 0, _IONBF, false };
+
+}
+
+FILE *stdout = &terminal_out;
+FILE *stderr = &terminal_err;
+FILE *stdserial = &serial_out;
+FILE *stdring = &ring_out;
@@ -0,0 +1,15 @@
+#include <stdio.h>
+
+int fflush(FILE *stream) {
+	if (!stream) {
+		// all of them, as in the standard
+		fflush(stdout);
+		fflush(stderr);
+		fflush(stdserial);
+		return fflush(stdring);
+	}
+
+	_stdio_internals::flush(stream);
+
+	return stream->error ? EOF : 0;
+}
@@ -0,0 +1,12 @@
+#include <stdio.h>
+
+#include <stdarg.h>
+
+int fprintf(FILE *__restrict stream, const char *__restrict format, ...) {
+	va_list parameters;
+	va_start(parameters, format);
+	const int res = vfprintf(stream, format, parameters);
+	va_end(parameters);
+
+	return res;
+}
@@ -0,0 +1,8 @@
+#include <stdio.h>
+
+int fputc(int ic, FILE *stream) {
+	const char c = ic;
+	_stdio_internals::write(stream, &c, 1);
+
+	return stream->error ? EOF : (unsigned char)c;
+}
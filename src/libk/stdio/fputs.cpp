@@ -0,0 +1,9 @@
+#include <stdio.h>
+
+#include <string.h>
+
+int fputs(const char *__restrict s, FILE *__restrict stream) {
+	_stdio_internals::write(stream, s, strlen(s));
+
+	return stream->error ? EOF : 0;
+}
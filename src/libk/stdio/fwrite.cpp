@@ -0,0 +1,10 @@
+#include <stdio.h>
+
+size_t fwrite(const void *__restrict ptr, size_t size, size_t nmemb, FILE *__restrict stream) {
+	if (size == 0 || nmemb == 0) return 0;
+
+	_stdio_internals::write(stream, (const char*)ptr, size*nmemb);
+
+	// can't tell how much got through, so all or nothing
+	return stream->error ? 0 : nmemb;
+}
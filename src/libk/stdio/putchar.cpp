@@ -1,9 +1,5 @@
 #include <stdio.h>
 
-#include "vga.hpp"
-
 int putchar(int c) {
-	term::putchar(c);
-
-	return c;
+	return fputc(c, stdout);
 }
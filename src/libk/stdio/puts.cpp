@@ -1,10 +1,6 @@
 #include <stdio.h>
 
-#include "vga.hpp"
-
 int puts(const char *s) {
-	term::writestring(s);
-	term::putchar('\n');
-
-	return 0;
+	if (fputs(s, stdout) == EOF) return EOF;
+	return fputc('\n', stdout) == EOF ? EOF : 0;
 }
@@ -0,0 +1,17 @@
+#include <stdio.h>
+
+#include <string.h>
+
+using namespace _stdio_internals;
+
+size_t ring_log_read(char *buf, size_t size) {
+	const size_t kept = ring_log_total < RING_LOG_SIZE ? ring_log_total : RING_LOG_SIZE;
+	const size_t len = size < kept ? size : kept;
+
+	const size_t pos = (ring_log_total - len) % RING_LOG_SIZE;
+	const size_t first = len < RING_LOG_SIZE - pos ? len : RING_LOG_SIZE - pos;
+	memcpy(buf, &ring_log[pos], first);
+	memcpy(buf + first, &ring_log[0], len - first);
+
+	return len;
+}
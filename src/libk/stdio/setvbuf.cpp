@@ -0,0 +1,14 @@
+#include <stdio.h>
+
+int setvbuf(FILE *__restrict stream, char *__restrict buf, int mode, size_t size) {
+	if (mode != _IOFBF && mode != _IOLBF && mode != _IONBF) return -1;
+
+	_stdio_internals::flush(stream);
+	if (buf) {
+		stream->buf = buf;
+		stream->size = size;
+	}
+	stream->mode = mode;
+
+	return 0;
+}
@@ -0,0 +1,12 @@
+#include <stdio.h>
+
+#include <stdarg.h>
+
+int snprintf(char *__restrict str, size_t size, const char *__restrict format, ...) {
+	va_list parameters;
+	va_start(parameters, format);
+	const int res = vsnprintf(str, size, format, parameters);
+	va_end(parameters);
+
+	return res;
+}
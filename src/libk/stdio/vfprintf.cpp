@@ -0,0 +1,36 @@
+#include <stdio.h>
+
+#include <stdarg.h>
+
+using namespace _stdio_internals;
+
+namespace {
+
+void write_out(void *stream, const char *data, size_t len) {
+	write_direct((FILE*)stream, data, len);
+}
+
+}
+
+int vfprintf(FILE *__restrict stream, const char *__restrict format, va_list parameters) {
+	if (stream->mode == _IONBF || stream->size == 0) {
+		// format on the stack, so that the backend gets everything in
+		// one write (for the terminal: the cursor only moves once),
+		// unless it's very long
+		char buf[PRINTF_BUF_SIZE];
+		sink_t sink = { buf, sizeof(buf), 0, 0, write_out, stream };
+
+		const int res = _stdio_internals::format(sink, format, parameters);
+		flush(sink);
+
+		return stream->error ? -1 : res;
+	}
+
+	// straight into the stream's own buffer
+	sink_t sink = { stream->buf, stream->size, stream->len, 0, write_out, stream };
+	const int res = _stdio_internals::format(sink, format, parameters);
+	stream->len = sink.len;
+	flush_lines(stream);
+
+	return stream->error ? -1 : res;
+}
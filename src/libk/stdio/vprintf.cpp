@@ -0,0 +1,7 @@
+#include <stdio.h>
+
+#include <stdarg.h>
+
+int vprintf(const char *__restrict format, va_list parameters) {
+	return vfprintf(stdout, format, parameters);
+}
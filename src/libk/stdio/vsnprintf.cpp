@@ -0,0 +1,16 @@
+#include <stdio.h>
+
+#include <stdarg.h>
+
+using namespace _stdio_internals;
+
+// writes at most size-1 characters and a null terminator, but returns how
+// long the whole output would have been
+int vsnprintf(char *__restrict str, size_t size, const char *__restrict format, va_list parameters) {
+	sink_t sink = { str, size ? size-1 : 0, 0, 0, nullptr, nullptr };
+
+	const int res = _stdio_internals::format(sink, format, parameters);
+	if (size) str[sink.len] = 0;
+
+	return res;
+}
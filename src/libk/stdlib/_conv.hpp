@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// helpers shared by utoa32, utoa64, dtoa and dtoa_fixed.
+//
+// There's no hardware 64-bit division on i686, so `x / 10` on a uint64_t
+// becomes a call to libgcc's __udivdi3, which is slow. Instead, division
+// by a constant is done by multiplying with its (rounded up) reciprocal
+// and keeping the high bits, which only takes a few 32-bit multiplies.
+
+namespace _conv_internals {
+
+// "00" "01" ... "99", so that digits can be written two at a time
+inline constexpr char DIGIT_PAIRS[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+inline void put_pair(char *p, uint32_t pair) {
+	p[0] = DIGIT_PAIRS[2*pair];
+	p[1] = DIGIT_PAIRS[2*pair + 1];
+}
+
+// x / 100 for any uint32_t, as a single 32x32->64 multiply
+inline uint32_t div100(uint32_t x) {
+	return (uint64_t(x) * 0x51EB851F) >> 37;
+}
+
+// the high 64 bits of the 128-bit product
+inline uint64_t mulhi64(uint64_t a, uint64_t b) {
+	const uint64_t a_lo = uint32_t(a), a_hi = a >> 32;
+	const uint64_t b_lo = uint32_t(b), b_hi = b >> 32;
+
+	const uint64_t lo_lo = a_lo * b_lo;
+	const uint64_t hi_lo = a_hi * b_lo;
+	const uint64_t lo_hi = a_lo * b_hi;
+	const uint64_t hi_hi = a_hi * b_hi;
+
+	// can't overflow: at most (2^32-1)^2 + 2*(2^32-1) = 2^64-1
+	const uint64_t cross = (lo_lo >> 32) + uint32_t(hi_lo) + lo_hi;
+	return hi_hi + (hi_lo >> 32) + (cross >> 32);
+}
+
+// x / 10^8 for any uint64_t
+inline uint64_t div1e8(uint64_t x) {
+	return mulhi64(x, 0xABCC77118461CEFDull) >> 26;
+}
+
+// the number of decimal digits in x
+inline size_t count_digits(uint32_t x) {
+	if (x < 10) return 1;
+	if (x < 100) return 2;
+	if (x < 1000) return 3;
+	if (x < 10000) return 4;
+	if (x < 100000) return 5;
+	if (x < 1000000) return 6;
+	if (x < 10000000) return 7;
+	if (x < 100000000) return 8;
+	if (x < 1000000000) return 9;
+	return 10;
+}
+
+// writes exactly 8 digits of x (< 10^8), with leading zeroes
+inline void put_8_digits(char *p, uint32_t x) {
+	const uint32_t hi = x / 10000; // also a multiply, as x is 32-bit
+	const uint32_t lo = x - hi*10000;
+	put_pair(p, div100(hi));
+	put_pair(p+2, hi - div100(hi)*100);
+	put_pair(p+4, div100(lo));
+	put_pair(p+6, lo - div100(lo)*100);
+}
+
+}
@@ -0,0 +1,69 @@
+#include <stdlib.h>
+
+#include <assert.h>
+
+/*
+ * The default block allocator backend: blocks are handed out exactly as
+ * requested, wherever find_free_run finds room for them, and is_used is
+ * the only bookkeeping there is.
+ */
+
+namespace _mm_internals {
+
+const char *const backend_name = "bitmap first-fit";
+
+size_t round_blocks(size_t count) {
+	return count;
+}
+
+size_t alloc_blocks(size_t count, size_t align) {
+	const size_t begin = find_free_run(count, align);
+
+	if (begin != num_blocks) set_used_span(begin, count);
+
+	return begin;
+}
+void free_blocks(size_t begin, size_t count) {
+	// verify that the memory hasn't already been freed
+	assert(is_used_span(begin, count) && "double free detected!");
+
+	set_free_span(begin, count);
+}
+
+bool grow_blocks(size_t begin, size_t curr, size_t req) {
+	if (free_run_length(begin+curr, req-curr) < req-curr) {
+		// not enough free memory directly after
+		return false;
+	}
+
+	set_used_span(begin+curr, req-curr);
+
+	return true;
+}
+void shrink_blocks(size_t begin, size_t curr, size_t req) {
+	free_blocks(begin+req, curr-req);
+}
+size_t grow_blocks_backwards(size_t begin, size_t curr, size_t req) {
+	// take whatever is free after the allocation first, so that as
+	// little as possible has to be moved
+	const size_t after = free_run_length(begin+curr, req-curr);
+	const size_t before = free_run_length_before(begin, req-curr-after);
+
+	if (before + after < req-curr) return num_blocks;
+
+	set_used_span(begin-before, before);
+	set_used_span(begin+curr, after);
+
+	return begin-before;
+}
+
+bool backend_keeps_data(size_t) {
+	return false;
+}
+
+size_t backend_meta_size() {
+	return 0;
+}
+void backend_init(void *) {}
+
+}
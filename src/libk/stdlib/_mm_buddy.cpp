@@ -0,0 +1,214 @@
+#include <stdlib.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Binary buddy block allocator backend, used instead of _mm_bitmap.cpp
+ * when building with MM_BACKEND=buddy.
+ *
+ * Allocations are rounded up to a power of two blocks (the block's
+ * order), and a block of order k always starts at a block index which is
+ * a multiple of 2^k. Its buddy is the other half of the order k+1 block
+ * it was split from, at index ^ 2^k. Free blocks are kept in a
+ * doubly linked list per order, linked through the free memory itself,
+ * and free_order records which order of free block (if any) starts at
+ * each block index, so that whether a buddy is free can be checked
+ * without walking any lists.
+ *
+ * Allocating splits a larger block down to size, freeing merges a block
+ * with its buddy for as long as the buddy is free, so both are O(log n).
+ * Growing an allocation in place works whenever the buddies it would be
+ * merged with are free.
+ *
+ * is_used is still kept up to date (which also keeps the summary up to
+ * date), but only for double free checks and for inspecting the heap;
+ * the placement setting is ignored.
+ */
+
+namespace _mm_internals {
+
+const char *const backend_name = "binary buddy";
+
+namespace {
+
+// largest block: 2^20 blocks = 1GiB
+static constexpr size_t MAX_ORDER = 20;
+
+struct free_block_t {
+	free_block_t *next;
+	free_block_t *prev;
+};
+
+free_block_t *free_lists[MAX_ORDER+1] = {0};
+// order+1 of the free block starting at each block index, or 0 if no
+// free block starts there
+uint8_t *free_order = nullptr;
+
+inline size_t order_of(size_t count) {
+	if (count <= 1) return 0;
+	return 32 - __builtin_clz(uint32_t(count-1));
+}
+
+void push(size_t idx, size_t order) {
+	free_block_t *block = (free_block_t*)get_ptr(idx);
+	block->prev = nullptr;
+	block->next = free_lists[order];
+	if (block->next) block->next->prev = block;
+	free_lists[order] = block;
+
+	free_order[idx] = order+1;
+	// the list links are written into the block
+	is_zero[idx/BITS_PER_WORD] &= ~(uint32_t(1) << (idx%BITS_PER_WORD));
+}
+void remove(size_t idx, size_t order) {
+	free_block_t *block = (free_block_t*)get_ptr(idx);
+	if (block->prev) block->prev->next = block->next;
+	else free_lists[order] = block->next;
+	if (block->next) block->next->prev = block->prev;
+
+	free_order[idx] = 0;
+}
+inline bool is_free_block(size_t idx, size_t order) {
+	return idx < num_blocks && free_order[idx] == order+1;
+}
+
+// split up the range [begin, begin+count) into the largest blocks possible
+void add_free_range(size_t begin, size_t count) {
+	while (count) {
+		size_t order = begin ? __builtin_ctz(uint32_t(begin)) : MAX_ORDER;
+		const size_t fits = 31 - __builtin_clz(uint32_t(count));
+		if (order > fits) order = fits;
+		if (order > MAX_ORDER) order = MAX_ORDER;
+
+		push(begin, order);
+
+		begin += size_t(1) << order;
+		count -= size_t(1) << order;
+	}
+}
+
+}
+
+size_t round_blocks(size_t count) {
+	const size_t order = order_of(count);
+	// too large to ever be allocated, let alloc_blocks fail on it
+	if (order > MAX_ORDER) return count;
+	return size_t(1) << order;
+}
+
+size_t alloc_blocks(size_t count, size_t align) {
+	const size_t order = order_of(count);
+	// blocks are aligned to their own size, and nothing needs more
+	// than that yet
+	assert((size_t(1) << order) % align == 0);
+
+	size_t from = order;
+	while (from <= MAX_ORDER && free_lists[from] == nullptr) ++from;
+	if (from > MAX_ORDER) return num_blocks;
+
+	const size_t begin = get_idx(free_lists[from]);
+	remove(begin, from);
+
+	// split off the upper halves until the block is the right size
+	while (from > order) {
+		--from;
+		push(begin + (size_t(1) << from), from);
+	}
+
+	set_used_span(begin, size_t(1) << order);
+
+	return begin;
+}
+void free_blocks(size_t begin, size_t count) {
+	// verify that the memory hasn't already been freed
+	assert(is_used_span(begin, count) && "double free detected!");
+	set_free_span(begin, count);
+
+	size_t order = order_of(count);
+	assert(count == size_t(1) << order);
+
+	// merge with the buddy for as long as it is free
+	while (order < MAX_ORDER) {
+		const size_t buddy = begin ^ (size_t(1) << order);
+		if (!is_free_block(buddy, order)) break;
+
+		remove(buddy, order);
+		if (buddy < begin) begin = buddy;
+		++order;
+	}
+
+	push(begin, order);
+}
+
+bool grow_blocks(size_t begin, size_t curr, size_t req) {
+	const size_t from = order_of(curr);
+	const size_t to = order_of(req);
+	if (to > MAX_ORDER) return false;
+
+	// the block can only grow upwards if it's the lower half of every
+	// block it'd be merged into
+	if (begin % (size_t(1) << to) != 0) return false;
+	for (size_t order = from; order < to; ++order) {
+		if (!is_free_block(begin + (size_t(1) << order), order)) return false;
+	}
+
+	for (size_t order = from; order < to; ++order) {
+		remove(begin + (size_t(1) << order), order);
+	}
+	set_used_span(begin+curr, req-curr);
+
+	return true;
+}
+void shrink_blocks(size_t begin, size_t curr, size_t req) {
+	assert(is_used_span(begin+req, curr-req) && "double free detected!");
+	set_free_span(begin+req, curr-req);
+
+	// give back the upper halves; their buddies are the lower halves,
+	// which are still in use, so there's nothing to merge with
+	for (size_t order = order_of(curr); order-- > order_of(req);) {
+		push(begin + (size_t(1) << order), order);
+	}
+}
+
+size_t grow_blocks_backwards(size_t, size_t, size_t) {
+	// a block can't move down without also changing its alignment,
+	// so this would amount to allocating a new block anyways
+	return num_blocks;
+}
+
+bool backend_keeps_data(size_t block) {
+	// the first block of each free block holds its list links
+	return free_order[block] != 0;
+}
+
+size_t backend_meta_size() {
+	return num_words * BITS_PER_WORD;
+}
+void backend_init(void *meta) {
+	free_order = (uint8_t*)meta;
+	memset(free_order, 0, backend_meta_size());
+	for (size_t order = 0; order <= MAX_ORDER; ++order) {
+		free_lists[order] = nullptr;
+	}
+
+	// everything that init left free goes into the free lists
+	size_t idx = 0;
+	while (idx < num_blocks) {
+		if (is_used[idx/BITS_PER_WORD] == FULL_WORD) {
+			idx = (idx/BITS_PER_WORD + 1) * BITS_PER_WORD;
+			continue;
+		}
+		if (get_used(idx)) {
+			++idx;
+			continue;
+		}
+
+		const size_t len = free_run_length(idx, num_blocks - idx);
+		add_free_range(idx, len);
+		idx += len;
+	}
+}
+
+}
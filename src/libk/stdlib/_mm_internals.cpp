@@ -1,7 +1,417 @@
 #include <stdlib.h>
 
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 
 namespace _mm_internals {
-	uint8_t is_used[NUM_BLOCKS / 8] = {0};
+	uintptr_t heap_base = 0;
+	size_t num_blocks = 0;
+	size_t num_words = 0;
+	size_t num_regions = 0;
+
+	uint32_t *is_used = nullptr;
+	uint32_t *is_slab = nullptr;
+	uint32_t *is_zero = nullptr;
+	run_summary_t *summary = nullptr;
+
+	Placement placement = Placement::FirstFit;
+
+	size_t free_run_length(size_t begin, size_t max) {
+		size_t len = 0;
+
+		while (len < max && begin + len < num_blocks) {
+			const size_t idx = begin + len;
+			const size_t bit = idx%BITS_PER_WORD;
+			const uint32_t used = is_used[idx/BITS_PER_WORD] >> bit;
+
+			if (used == 0) {
+				// rest of the word is free
+				len += BITS_PER_WORD - bit;
+			} else {
+				len += __builtin_ctz(used);
+				break;
+			}
+		}
+
+		if (begin + len > num_blocks) len = num_blocks - begin;
+		return len < max ? len : max;
+	}
+	size_t free_run_length_before(size_t begin, size_t max) {
+		size_t len = 0;
+
+		while (len < max && len < begin) {
+			const size_t idx = begin - len - 1;
+			const size_t bit = idx%BITS_PER_WORD;
+			// the blocks of the word up to idx, moved to the top
+			const uint32_t used = is_used[idx/BITS_PER_WORD] << (BITS_PER_WORD-1 - bit);
+
+			if (used == 0) {
+				// start of the word is free
+				len += bit + 1;
+			} else {
+				len += __builtin_clz(used);
+				break;
+			}
+		}
+
+		if (len > begin) len = begin;
+		return len < max ? len : max;
+	}
+
+	namespace {
+		// the number of blocks covered by a node in the summary tree
+		inline size_t node_blocks(size_t node) {
+			const size_t depth = 31 - __builtin_clz(uint32_t(node));
+			return (num_regions >> depth) * REGION_BLOCKS;
+		}
+
+		// length of the longest run of set bits
+		inline size_t longest_ones(uint32_t x) {
+			size_t len = 0;
+			while (x) {
+				x &= x << 1;
+				++len;
+			}
+			return len;
+		}
+
+		void summarise_region(size_t region) {
+			size_t prefix = 0;
+			size_t largest = 0;
+			size_t run = 0;
+			bool in_prefix = true;
+
+			const size_t first_word = region * WORDS_PER_REGION;
+			for (size_t word = first_word; word < first_word + WORDS_PER_REGION; ++word) {
+				const uint32_t used = is_used[word];
+
+				if (used == 0) {
+					run += BITS_PER_WORD;
+					continue;
+				}
+
+				// the run going into this word ends at its first used block
+				run += __builtin_ctz(used);
+				if (run > largest) largest = run;
+				if (in_prefix) {
+					prefix = run;
+					in_prefix = false;
+				}
+
+				// runs inside the word; this also counts the runs
+				// at either end, but those are never longer than
+				// the runs they're part of
+				const size_t inner = longest_ones(~used);
+				if (inner > largest) largest = inner;
+
+				// and the run going out of this word starts after its last
+				run = __builtin_clz(used);
+			}
+
+			if (run > largest) largest = run;
+			if (in_prefix) prefix = run;
+
+			run_summary_t &leaf = summary[num_regions + region];
+			leaf.prefix = prefix;
+			leaf.suffix = run;
+			leaf.largest = largest;
+		}
+		void summarise_node(size_t node) {
+			const run_summary_t &left = summary[2*node];
+			const run_summary_t &right = summary[2*node + 1];
+			const size_t half = node_blocks(node) / 2;
+
+			run_summary_t &res = summary[node];
+			res.prefix = left.prefix == half
+				? half + right.prefix
+				: left.prefix;
+			res.suffix = right.suffix == half
+				? half + left.suffix
+				: right.suffix;
+			res.largest = left.largest > right.largest
+				? left.largest
+				: right.largest;
+			if (left.suffix + right.prefix > res.largest) {
+				res.largest = left.suffix + right.prefix;
+			}
+		}
+
+		// the first free run of `count` blocks in the words [first_word, end_word)
+		size_t scan_for_free_run(size_t first_word, size_t end_word, size_t count, size_t align) {
+			// the run of free blocks currently being looked at,
+			// which may stretch over multiple words
+			size_t run_begin = 0;
+			size_t run_len = 0;
+
+			for (size_t word = first_word; word < end_word; ++word) {
+				const uint32_t used = is_used[word];
+
+				if (used == FULL_WORD) {
+					run_len = 0;
+					continue;
+				}
+
+				size_t bit = 0;
+				while (bit < BITS_PER_WORD) {
+					const uint32_t free_bits = ~used >> bit;
+					if (free_bits == 0) {
+						// rest of the word is used
+						run_len = 0;
+						break;
+					}
+
+					// skip to the start of the next free run
+					const size_t to_skip = __builtin_ctz(free_bits);
+					if (to_skip) {
+						run_len = 0;
+						bit += to_skip;
+					}
+
+					// and find where it ends
+					const uint32_t used_bits = used >> bit;
+					const size_t len = used_bits
+						? __builtin_ctz(used_bits)
+						: BITS_PER_WORD - bit;
+
+					if (run_len == 0) run_begin = word*BITS_PER_WORD + bit;
+					run_len += len;
+					bit += len;
+
+					const size_t aligned_begin = (run_begin + align-1) / align * align;
+					if (run_begin + run_len >= aligned_begin + count) {
+						return aligned_begin;
+					}
+				}
+			}
+
+			return num_blocks;
+		}
+		// the start of the first free run of at least `count` blocks
+		size_t find_in_summary(size_t count) {
+			if (summary[1].largest < count) return num_blocks;
+
+			// walk down the tree, always going left if the run can be
+			// found there
+			size_t node = 1;
+			size_t node_begin = 0;
+			while (node < num_regions) {
+				const run_summary_t &left = summary[2*node];
+				const run_summary_t &right = summary[2*node + 1];
+				const size_t half = node_blocks(node) / 2;
+
+				if (left.largest >= count) {
+					node = 2*node;
+				} else if (left.suffix + right.prefix >= count) {
+					// the run straddles the two halves
+					return node_begin + half - left.suffix;
+				} else {
+					node = 2*node + 1;
+					node_begin += half;
+				}
+			}
+
+			// the run lies within this region
+			const size_t first_word = (node - num_regions) * WORDS_PER_REGION;
+			return scan_for_free_run(first_word, first_word + WORDS_PER_REGION, count, 1);
+		}
+		size_t find_free_run_first_fit(size_t count, size_t align) {
+			if (align == 1) return find_in_summary(count);
+
+			// any run this long contains a properly aligned run
+			const size_t begin = find_in_summary(count + align-1);
+			if (begin != num_blocks) {
+				return (begin + align-1) / align * align;
+			}
+
+			// the only runs left might be just long enough;
+			// fall back to checking each one
+			return scan_for_free_run(0, num_words, count, align);
+		}
+		size_t find_free_run_strided(size_t count, size_t align) {
+			// very simple adjustment to make the memory allocator
+			// slightly more likely to result in efficient reallocs
+			// (kept a multiple of 32 so that it stays a multiple of align)
+			size_t spacing = num_blocks / 512 / 32 * 32;
+			if (spacing < 32) spacing = 32;
+			for (size_t small_step = 0; small_step < spacing; small_step += align) {
+				for (size_t large_step = 0; large_step < num_blocks; large_step += spacing) {
+					const size_t i = large_step + small_step;
+
+					if (i + count > num_blocks) break;
+
+					if (is_free_span(i, count)) return i;
+				}
+			}
+
+			return num_blocks;
+		}
+	}
+
+	void update_summary(size_t begin, size_t count) {
+		if (count == 0) return;
+
+		const size_t first_region = begin / REGION_BLOCKS;
+		const size_t last_region = (begin + count-1) / REGION_BLOCKS;
+
+		for (size_t region = first_region; region <= last_region; ++region) {
+			summarise_region(region);
+		}
+
+		// and update all the nodes above the changed regions
+		size_t first_node = (num_regions + first_region) / 2;
+		size_t last_node = (num_regions + last_region) / 2;
+		while (first_node) {
+			for (size_t node = first_node; node <= last_node; ++node) {
+				summarise_node(node);
+			}
+			first_node /= 2;
+			last_node /= 2;
+		}
+	}
+	void rebuild_summary() {
+		update_summary(0, num_regions * REGION_BLOCKS);
+	}
+
+	void init(const mem_range_t *usable, size_t count) {
+		// blocks need to be 1KiB aligned, and the slab allocator
+		// additionally likes block indices that are a multiple of 4
+		// to be 4KiB aligned
+		constexpr uintptr_t BASE_ALIGN = SLAB_BLOCKS * MIN_ALLOC_SIZE;
+
+		uintptr_t lowest = UINTPTR_MAX;
+		uintptr_t highest = 0;
+		for (size_t i = 0; i < count; ++i) {
+			if (usable[i].begin < lowest) lowest = usable[i].begin;
+			if (usable[i].end > highest) highest = usable[i].end;
+		}
+		if (lowest >= highest) {
+			puts("kernel: panic: no usable memory for the heap!");
+			abort();
+		}
+
+		heap_base = lowest & ~(BASE_ALIGN-1);
+		num_blocks = (highest - heap_base) / MIN_ALLOC_SIZE;
+		num_regions = 1;
+		while (num_regions * REGION_BLOCKS < num_blocks) num_regions *= 2;
+		num_words = num_regions * WORDS_PER_REGION;
+
+		// find somewhere to keep the bookkeeping itself
+		const size_t bitset_size = num_words * sizeof(uint32_t);
+		const size_t summary_size = 2*num_regions * sizeof(run_summary_t);
+		const size_t meta_size = 3*bitset_size + summary_size
+			+ backend_meta_size();
+		uintptr_t meta = 0;
+		for (size_t i = 0; i < count; ++i) {
+			const uintptr_t begin = (usable[i].begin + MIN_ALLOC_SIZE-1) & ~(MIN_ALLOC_SIZE-1);
+			if (begin < usable[i].end && usable[i].end - begin >= meta_size) {
+				meta = begin;
+				break;
+			}
+		}
+		if (meta == 0) {
+			puts("kernel: panic: no room for the memory allocator's bookkeeping!");
+			abort();
+		}
+
+		is_used = (uint32_t*)meta;
+		is_slab = (uint32_t*)(meta + bitset_size);
+		is_zero = (uint32_t*)(meta + 2*bitset_size);
+		summary = (run_summary_t*)(meta + 3*bitset_size);
+
+		// everything starts off as used, and then only the usable
+		// ranges are freed up
+		memset(is_used, 0xFF, bitset_size);
+		memset(is_slab, 0, bitset_size);
+		// nothing is known about what's in memory at boot, unless
+		// told otherwise (but is_zero doesn't mean anything for used
+		// blocks anyways, so it can just be the inverse of is_used)
+#ifdef MM_ZEROED_RAM
+		constexpr bool ram_is_zeroed = true;
+#else
+		constexpr bool ram_is_zeroed = false;
+#endif
+		for (size_t i = 0; i < count; ++i) {
+			// only whole blocks can be used
+			const size_t begin = (usable[i].begin - heap_base + MIN_ALLOC_SIZE-1) / MIN_ALLOC_SIZE;
+			const size_t end = (usable[i].end - heap_base) / MIN_ALLOC_SIZE;
+			if (begin >= end) continue;
+
+			for_each_span_word(begin, end - begin, [](size_t word, uint32_t mask) {
+				is_used[word] &= ~mask;
+			});
+		}
+		const size_t meta_begin = get_idx((void*)meta);
+		const size_t meta_blocks = (meta_size + MIN_ALLOC_SIZE-1) / MIN_ALLOC_SIZE;
+		for_each_span_word(meta_begin, meta_blocks, [](size_t word, uint32_t mask) {
+			is_used[word] |= mask;
+		});
+
+		for (size_t word = 0; word < num_words; ++word) {
+			is_zero[word] = ram_is_zeroed ? ~is_used[word] : 0;
+		}
+
+		rebuild_summary();
+
+		stats.total_blocks = 0;
+		for (size_t word = 0; word < num_words; ++word) {
+			stats.total_blocks += BITS_PER_WORD - __builtin_popcount(is_used[word]);
+		}
+
+		backend_init((void*)(meta + 3*bitset_size + summary_size));
+	}
+
+	size_t zero_dirty_blocks(size_t begin, size_t count) {
+		size_t res = 0;
+		for_each_span_word(begin, count, [&res](size_t word, uint32_t mask) {
+			uint32_t dirty = mask & ~is_zero[word];
+			while (dirty) {
+				const size_t bit = __builtin_ctz(dirty);
+				dirty &= dirty - 1;
+
+				memset(get_ptr(word*BITS_PER_WORD + bit), 0, MIN_ALLOC_SIZE);
+				++res;
+			}
+		});
+		return res;
+	}
+
+	namespace {
+		// where zero_free_blocks left off
+		size_t zero_scan_word = 0;
+	}
+	size_t zero_free_blocks(size_t max) {
+		size_t res = 0;
+
+		for (size_t i = 0; i < num_words && res < max; ++i) {
+			const size_t word = zero_scan_word;
+
+			uint32_t dirty = ~is_used[word] & ~is_zero[word];
+			while (dirty && res < max) {
+				const size_t bit = __builtin_ctz(dirty);
+				dirty &= dirty - 1;
+
+				const size_t block = word*BITS_PER_WORD + bit;
+				if (backend_keeps_data(block)) continue;
+
+				memset(get_ptr(block), 0, MIN_ALLOC_SIZE);
+				is_zero[word] |= uint32_t(1) << bit;
+				++res;
+			}
+
+			// only move on once this word is done
+			if (dirty == 0) zero_scan_word = (word + 1) % num_words;
+		}
+
+		return res;
+	}
+
+	size_t find_free_run(size_t count, size_t align) {
+		switch (placement) {
+			case Placement::FirstFit: return find_free_run_first_fit(count, align);
+			case Placement::Strided: return find_free_run_strided(count, align);
+		}
+
+		return num_blocks;
+	}
 };
@@ -0,0 +1,174 @@
+#include <stdlib.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Slab allocator for small objects.
+ *
+ * Each size class (8, 16, 32, ..., 512 bytes) gets its own 4KiB slabs,
+ * which are taken from the block allocator like any other allocation, but
+ * marked in the is_slab bitset so that free and realloc can tell slab
+ * objects apart from block allocations.
+ *
+ * A slab starts with a slab_t header, followed by as many objects as fit.
+ * Freed objects are kept in an intrusive free list inside the slab, and
+ * objects that have never been handed out are carved off the end of the
+ * used area, so both allocating and freeing are O(1).
+ */
+
+namespace _mm_internals {
+
+bool slab_enabled = true;
+
+namespace {
+
+struct slab_t {
+	slab_t *next;
+	slab_t *prev;
+	// objects which have been freed, linked through their first word
+	void *free_list;
+	uint16_t size_class;
+	uint16_t capacity;
+	uint16_t num_used;
+	// objects [0, num_carved) have been handed out at least once
+	uint16_t num_carved;
+	// the slab's memory was all zero when it was set up, so objects which
+	// haven't been handed out yet are still zero
+	bool zeroed;
+};
+
+static constexpr size_t SLAB_SIZE = SLAB_BLOCKS * MIN_ALLOC_SIZE;
+// objects start right after the header, keeping malloc's 8 byte alignment
+static constexpr size_t OBJS_OFFSET = (sizeof(slab_t) + 7) & ~size_t(7);
+
+// slabs with at least one free object, per size class
+slab_t *partial[NUM_SLAB_CLASSES] = {0};
+
+inline size_t class_size(size_t size_class) {
+	return SLAB_MIN_SIZE << size_class;
+}
+inline size_t size_class_of(size_t size) {
+	if (size <= SLAB_MIN_SIZE) return 0;
+	// round up to the next power of two, counting from SLAB_MIN_SIZE = 2^3
+	return 32 - __builtin_clz(uint32_t(size-1)) - 3;
+}
+
+inline slab_t *slab_of(void *p) {
+	const size_t idx = get_idx(p);
+	return (slab_t*)get_ptr(idx - idx%SLAB_BLOCKS);
+}
+inline uint8_t *objects_of(slab_t *slab) {
+	return (uint8_t*)slab + OBJS_OFFSET;
+}
+
+void unlink(slab_t *slab) {
+	if (slab->prev) slab->prev->next = slab->next;
+	else partial[slab->size_class] = slab->next;
+	if (slab->next) slab->next->prev = slab->prev;
+	slab->next = slab->prev = nullptr;
+}
+void push_partial(slab_t *slab) {
+	slab->prev = nullptr;
+	slab->next = partial[slab->size_class];
+	if (slab->next) slab->next->prev = slab;
+	partial[slab->size_class] = slab;
+}
+
+slab_t *new_slab(size_t size_class) {
+	const size_t begin = alloc_blocks(SLAB_BLOCKS, SLAB_BLOCKS);
+
+	if (begin == num_blocks) {
+		puts("kernel: panic: couldn't allocate memory for slab!");
+		abort();
+	}
+
+	set_slab_span(begin, SLAB_BLOCKS);
+	const bool zeroed = is_zero_span(begin, SLAB_BLOCKS);
+
+	slab_t *slab = (slab_t*)get_ptr(begin);
+	slab->next = nullptr;
+	slab->prev = nullptr;
+	slab->free_list = nullptr;
+	slab->size_class = size_class;
+	slab->capacity = (SLAB_SIZE - OBJS_OFFSET) / class_size(size_class);
+	slab->num_used = 0;
+	slab->num_carved = 0;
+	slab->zeroed = zeroed;
+
+	push_partial(slab);
+
+	return slab;
+}
+void release_slab(slab_t *slab) {
+	unlink(slab);
+
+	const size_t begin = get_idx(slab);
+	clear_slab_span(begin, SLAB_BLOCKS);
+	free_blocks(begin, SLAB_BLOCKS);
+}
+
+}
+
+void *slab_alloc(size_t size, bool zero) {
+	assert(size <= SLAB_MAX_SIZE);
+
+	const size_t size_class = size_class_of(size);
+
+	slab_t *slab = partial[size_class];
+	if (slab == nullptr) slab = new_slab(size_class);
+
+	void *res;
+	bool known_zero;
+	if (slab->free_list) {
+		res = slab->free_list;
+		slab->free_list = *(void**)res;
+		known_zero = false;
+	} else {
+		assert(slab->num_carved < slab->capacity);
+		res = objects_of(slab) + slab->num_carved*class_size(size_class);
+		++slab->num_carved;
+		known_zero = slab->zeroed;
+	}
+
+	if (zero) {
+		if (known_zero) stats.zeroing_skipped += size;
+		else memset(res, 0, size);
+	}
+
+	if (++slab->num_used == slab->capacity) {
+		// full slabs don't need to be found again until something
+		// in them is freed
+		unlink(slab);
+	}
+
+	return res;
+}
+void slab_free(void *p) {
+	slab_t *slab = slab_of(p);
+
+	const size_t offset = (uint8_t*)p - objects_of(slab);
+	assert(offset % class_size(slab->size_class) == 0 && "passed a pointer to free that isn't from malloc");
+	assert(offset / class_size(slab->size_class) < slab->num_carved && "passed a pointer to free that isn't from malloc");
+	assert(slab->num_used > 0 && "double free detected!");
+
+	if (slab->num_used == slab->capacity) push_partial(slab);
+
+	*(void**)p = slab->free_list;
+	slab->free_list = p;
+	--slab->num_used;
+
+	// hand empty slabs back to the block allocator,
+	// but keep the last one around so that a single object being
+	// allocated and freed in a loop doesn't keep creating new slabs
+	if (slab->num_used == 0 && (slab->prev || slab->next)) {
+		release_slab(slab);
+	}
+}
+size_t slab_size(void *p) {
+	return class_size(slab_of(p)->size_class);
+}
+
+}
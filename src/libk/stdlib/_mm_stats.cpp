@@ -0,0 +1,46 @@
+#include <stdlib.h>
+
+#include <stdint.h>
+
+namespace _mm_internals {
+
+heap_stats_t stats = {};
+
+size_t usable_size(void *p) {
+	if (get_slab(get_idx(p))) return slab_size(p);
+
+	const alloc_header_t *header = (alloc_header_t*)p - 1;
+	return header->s.num_blocks*MIN_ALLOC_SIZE - HEADER_SIZE;
+}
+
+#ifdef MM_TRACE_CALLERS
+
+caller_stats_t callers[NUM_CALLER_SLOTS] = {};
+size_t untraced_allocs = 0;
+
+void trace_caller(void *caller, size_t size) {
+	// return addresses are at least a couple of bytes apart, so mix the
+	// high bits in a bit (Fibonacci hashing)
+	size_t slot = (uint32_t(uintptr_t(caller)) * 2654435769u) >> 24;
+
+	// linear probing; nothing is ever removed, so the first empty slot
+	// means the caller isn't in the table yet
+	for (size_t i = 0; i < NUM_CALLER_SLOTS; ++i) {
+		caller_stats_t &entry = callers[slot];
+
+		if (entry.addr == caller || entry.addr == nullptr) {
+			entry.addr = caller;
+			++entry.allocs;
+			entry.bytes += size;
+			return;
+		}
+
+		slot = (slot + 1) % NUM_CALLER_SLOTS;
+	}
+
+	++untraced_allocs;
+}
+
+#endif
+
+}
@@ -1,12 +1,10 @@
 #include <stdlib.h>
 
 #include <stdio.h>
-#include <string.h>
 
 void *calloc(size_t n, size_t size) {
-	void *res = malloc(n*size); // should technically check for overflow...
+	_MM_TRACE_CALLER(n*size);
 
-	memset(res, 0, n*size);
-
-	return res;
+	// alloc only clears memory that isn't known to be zero already
+	return _mm_internals::alloc(n*size, true); // should technically check for overflow...
 }
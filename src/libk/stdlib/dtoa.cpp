@@ -0,0 +1,336 @@
+#include <stdlib.h>
+
+#include <string.h>
+
+#include "_conv.hpp"
+
+using namespace _conv_internals;
+
+// Grisu2, from Florian Loitsch's "Printing Floating-Point Numbers Quickly
+// and Accurately with Integers" (2010), along the lines of Milo Yip's
+// implementation. It always gives digits which read back as the same
+// double, and nearly always the shortest such digits (very rarely one
+// more than needed), using only 64-bit integer arithmetic.
+
+namespace {
+
+// f * 2^e
+struct diy_fp {
+	uint64_t f;
+	int e;
+};
+
+constexpr uint64_t HIDDEN_BIT = uint64_t(1) << 52;
+constexpr uint64_t SIGNIFICAND_MASK = HIDDEN_BIT - 1;
+constexpr int EXPONENT_BIAS = 0x3FF + 52;
+
+diy_fp from_double(double d) {
+	uint64_t bits;
+	memcpy(&bits, &d, sizeof(bits));
+
+	const int biased_e = (bits >> 52) & 0x7FF;
+	const uint64_t significand = bits & SIGNIFICAND_MASK;
+	if (biased_e != 0) return { significand + HIDDEN_BIT, biased_e - EXPONENT_BIAS };
+	// subnormal
+	return { significand, 1 - EXPONENT_BIAS };
+}
+
+// the product, rounded to 64 bits
+diy_fp multiply(diy_fp a, diy_fp b) {
+	const uint64_t a_lo = uint32_t(a.f), a_hi = a.f >> 32;
+	const uint64_t b_lo = uint32_t(b.f), b_hi = b.f >> 32;
+
+	const uint64_t lo_lo = a_lo * b_lo;
+	const uint64_t hi_lo = a_hi * b_lo;
+	const uint64_t lo_hi = a_lo * b_hi;
+	const uint64_t hi_hi = a_hi * b_hi;
+
+	uint64_t cross = (lo_lo >> 32) + uint32_t(hi_lo) + uint32_t(lo_hi);
+	cross += uint64_t(1) << 31; // round
+	return { hi_hi + (hi_lo >> 32) + (lo_hi >> 32) + (cross >> 32), a.e + b.e + 64 };
+}
+
+// shift so that the top bit of f is set
+diy_fp normalize(diy_fp x) {
+	const int shift = __builtin_clzll(x.f);
+	return { x.f << shift, x.e - shift };
+}
+
+// the boundaries halfway to the neighbouring doubles, normalized, with
+// the same exponent
+void boundaries(diy_fp v, diy_fp &minus, diy_fp &plus) {
+	plus = normalize({ (v.f << 1) + 1, v.e - 1 });
+	// the gap below is half as big at a power of two (except for the
+	// smallest normal exponent)
+	minus = v.f == HIDDEN_BIT && v.e > 1 - EXPONENT_BIAS
+		? diy_fp { (v.f << 2) - 1, v.e - 2 }
+		: diy_fp { (v.f << 1) - 1, v.e - 1 };
+	minus.f <<= minus.e - plus.e;
+	minus.e = plus.e;
+}
+
+// 10^k for k = -348, -340, ..., 340, normalized and rounded
+constexpr struct { uint64_t f; int e; } CACHED_POWERS[] = {
+	{ 0xfa8fd5a0081c0288ull, -1220 },
+	{ 0xbaaee17fa23ebf76ull, -1193 },
+	{ 0x8b16fb203055ac76ull, -1166 },
+	{ 0xcf42894a5dce35eaull, -1140 },
+	{ 0x9a6bb0aa55653b2dull, -1113 },
+	{ 0xe61acf033d1a45dfull, -1087 },
+	{ 0xab70fe17c79ac6caull, -1060 },
+	{ 0xff77b1fcbebcdc4full, -1034 },
+	{ 0xbe5691ef416bd60cull, -1007 },
+	{ 0x8dd01fad907ffc3cull, -980 },
+	{ 0xd3515c2831559a83ull, -954 },
+	{ 0x9d71ac8fada6c9b5ull, -927 },
+	{ 0xea9c227723ee8bcbull, -901 },
+	{ 0xaecc49914078536dull, -874 },
+	{ 0x823c12795db6ce57ull, -847 },
+	{ 0xc21094364dfb5637ull, -821 },
+	{ 0x9096ea6f3848984full, -794 },
+	{ 0xd77485cb25823ac7ull, -768 },
+	{ 0xa086cfcd97bf97f4ull, -741 },
+	{ 0xef340a98172aace5ull, -715 },
+	{ 0xb23867fb2a35b28eull, -688 },
+	{ 0x84c8d4dfd2c63f3bull, -661 },
+	{ 0xc5dd44271ad3cdbaull, -635 },
+	{ 0x936b9fcebb25c996ull, -608 },
+	{ 0xdbac6c247d62a584ull, -582 },
+	{ 0xa3ab66580d5fdaf6ull, -555 },
+	{ 0xf3e2f893dec3f126ull, -529 },
+	{ 0xb5b5ada8aaff80b8ull, -502 },
+	{ 0x87625f056c7c4a8bull, -475 },
+	{ 0xc9bcff6034c13053ull, -449 },
+	{ 0x964e858c91ba2655ull, -422 },
+	{ 0xdff9772470297ebdull, -396 },
+	{ 0xa6dfbd9fb8e5b88full, -369 },
+	{ 0xf8a95fcf88747d94ull, -343 },
+	{ 0xb94470938fa89bcfull, -316 },
+	{ 0x8a08f0f8bf0f156bull, -289 },
+	{ 0xcdb02555653131b6ull, -263 },
+	{ 0x993fe2c6d07b7facull, -236 },
+	{ 0xe45c10c42a2b3b06ull, -210 },
+	{ 0xaa242499697392d3ull, -183 },
+	{ 0xfd87b5f28300ca0eull, -157 },
+	{ 0xbce5086492111aebull, -130 },
+	{ 0x8cbccc096f5088ccull, -103 },
+	{ 0xd1b71758e219652cull, -77 },
+	{ 0x9c40000000000000ull, -50 },
+	{ 0xe8d4a51000000000ull, -24 },
+	{ 0xad78ebc5ac620000ull, 3 },
+	{ 0x813f3978f8940984ull, 30 },
+	{ 0xc097ce7bc90715b3ull, 56 },
+	{ 0x8f7e32ce7bea5c70ull, 83 },
+	{ 0xd5d238a4abe98068ull, 109 },
+	{ 0x9f4f2726179a2245ull, 136 },
+	{ 0xed63a231d4c4fb27ull, 162 },
+	{ 0xb0de65388cc8ada8ull, 189 },
+	{ 0x83c7088e1aab65dbull, 216 },
+	{ 0xc45d1df942711d9aull, 242 },
+	{ 0x924d692ca61be758ull, 269 },
+	{ 0xda01ee641a708deaull, 295 },
+	{ 0xa26da3999aef774aull, 322 },
+	{ 0xf209787bb47d6b85ull, 348 },
+	{ 0xb454e4a179dd1877ull, 375 },
+	{ 0x865b86925b9bc5c2ull, 402 },
+	{ 0xc83553c5c8965d3dull, 428 },
+	{ 0x952ab45cfa97a0b3ull, 455 },
+	{ 0xde469fbd99a05fe3ull, 481 },
+	{ 0xa59bc234db398c25ull, 508 },
+	{ 0xf6c69a72a3989f5cull, 534 },
+	{ 0xb7dcbf5354e9beceull, 561 },
+	{ 0x88fcf317f22241e2ull, 588 },
+	{ 0xcc20ce9bd35c78a5ull, 614 },
+	{ 0x98165af37b2153dfull, 641 },
+	{ 0xe2a0b5dc971f303aull, 667 },
+	{ 0xa8d9d1535ce3b396ull, 694 },
+	{ 0xfb9b7cd9a4a7443cull, 720 },
+	{ 0xbb764c4ca7a44410ull, 747 },
+	{ 0x8bab8eefb6409c1aull, 774 },
+	{ 0xd01fef10a657842cull, 800 },
+	{ 0x9b10a4e5e9913129ull, 827 },
+	{ 0xe7109bfba19c0c9dull, 853 },
+	{ 0xac2820d9623bf429ull, 880 },
+	{ 0x80444b5e7aa7cf85ull, 907 },
+	{ 0xbf21e44003acdd2dull, 933 },
+	{ 0x8e679c2f5e44ff8full, 960 },
+	{ 0xd433179d9c8cb841ull, 986 },
+	{ 0x9e19db92b4e31ba9ull, 1013 },
+	{ 0xeb96bf6ebadf77d9ull, 1039 },
+	{ 0xaf87023b9bf0ee6bull, 1066 },};
+constexpr int CACHED_POWERS_MIN_K = -348;
+constexpr int CACHED_POWERS_STEP = 8;
+
+// a power of ten 10^-k such that multiplying a number with exponent e by it
+// brings the exponent into [-60, -32]
+diy_fp cached_power(int e, int &k) {
+	// ceil((-61 - e) * log10(2)), with floor(x * log10(2)) as
+	// (x * 78913) >> 18, which holds for |x| < 2^11 or so
+	const int x = -61 - e;
+	const int min_k = x == 0 ? 0 : ((x * 78913) >> 18) + 1;
+
+	const size_t index = (min_k - CACHED_POWERS_MIN_K + CACHED_POWERS_STEP - 1) / CACHED_POWERS_STEP;
+	k = -(CACHED_POWERS_MIN_K + int(index) * CACHED_POWERS_STEP);
+	return { CACHED_POWERS[index].f, CACHED_POWERS[index].e };
+}
+
+constexpr uint32_t POW10_32[] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+};
+constexpr uint64_t POW10_64[] = {
+	1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull,
+	10000000ull, 100000000ull, 1000000000ull, 10000000000ull,
+	100000000000ull, 1000000000000ull, 10000000000000ull,
+	100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+	100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull,
+};
+
+// nudge the last digit down while that brings it closer to the actual value
+void round_last(char *digits, size_t len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+	while (rest < wp_w && delta - rest >= ten_kappa
+		&& (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)
+	) {
+		--digits[len-1];
+		rest += ten_kappa;
+	}
+}
+
+// generates the digits of the number, as few as possible while staying
+// within delta of the upper boundary Mp; k gets the decimal exponent
+size_t generate_digits(diy_fp w, diy_fp Mp, uint64_t delta, char *digits, int &k) {
+	const int shift = -Mp.e;
+	const uint64_t one = uint64_t(1) << shift;
+	const uint64_t wp_w = Mp.f - w.f;
+
+	// the integral and fractional parts
+	uint32_t p1 = Mp.f >> shift;
+	uint64_t p2 = Mp.f & (one - 1);
+
+	size_t len = 0;
+	int kappa = count_digits(p1);
+	while (kappa > 0) {
+		const uint32_t pow = POW10_32[kappa-1];
+		const uint32_t d = p1 / pow;
+		p1 -= d * pow;
+		if (d || len) digits[len++] = '0' + d;
+		--kappa;
+
+		const uint64_t rest = (uint64_t(p1) << shift) + p2;
+		if (rest <= delta) {
+			k += kappa;
+			round_last(digits, len, delta, rest, uint64_t(POW10_32[kappa]) << shift, wp_w);
+			return len;
+		}
+	}
+
+	for (;;) {
+		p2 *= 10;
+		delta *= 10;
+		const char d = p2 >> shift;
+		if (d || len) digits[len++] = '0' + d;
+		p2 &= one - 1;
+		--kappa;
+
+		if (p2 < delta) {
+			k += kappa;
+			const int index = -kappa;
+			round_last(digits, len, delta, p2, one, index < 20 ? wp_w * POW10_64[index] : 0);
+			return len;
+		}
+	}
+}
+
+// the shortest (nearly) digits of d, which must be positive and finite;
+// d = digits * 10^k
+size_t grisu2(double d, char *digits, int &k) {
+	const diy_fp v = from_double(d);
+	diy_fp minus, plus;
+	boundaries(v, minus, plus);
+
+	const diy_fp c_mk = cached_power(plus.e, k);
+	const diy_fp w = multiply(normalize(v), c_mk);
+	diy_fp Wp = multiply(plus, c_mk);
+	diy_fp Wm = multiply(minus, c_mk);
+	// stay strictly inside the boundaries, to be safe from the rounding
+	++Wm.f;
+	--Wp.f;
+
+	return generate_digits(w, Wp, Wp.f - Wm.f, digits, k);
+}
+
+size_t write_exponent(int e, char *buf) {
+	size_t len = 0;
+	buf[len++] = 'e';
+	if (e < 0) {
+		buf[len++] = '-';
+		e = -e;
+	} else {
+		buf[len++] = '+';
+	}
+	if (e < 10) buf[len++] = '0';
+	return len + utoa32(e, &buf[len]);
+}
+
+}
+
+size_t dtoa(double d, char *buf) {
+	uint64_t bits;
+	memcpy(&bits, &d, sizeof(bits));
+
+	size_t sign = 0;
+	if (bits >> 63) {
+		buf[0] = '-';
+		sign = 1;
+		d = -d;
+	}
+	buf += sign;
+
+	if (d != d) {
+		// no sign for nan
+		memcpy(buf - sign, "nan", 3);
+		return 3;
+	}
+	if (d == 0) {
+		buf[0] = '0';
+		return sign + 1;
+	}
+	if (d > 1.7976931348623157e308) {
+		memcpy(buf, "inf", 3);
+		return sign + 3;
+	}
+
+	char *const digits = buf;
+	int k;
+	const int len = grisu2(d, digits, k);
+	// the decimal point goes after the point'th digit
+	const int point = len + k;
+
+	if (0 <= k && point <= 21) {
+		// 1234e7 -> 12340000000
+		memset(&buf[len], '0', k);
+		return sign + point;
+	}
+	if (0 < point && point <= 21) {
+		// 1234e-2 -> 12.34
+		memmove(&buf[point+1], &buf[point], len - point);
+		buf[point] = '.';
+		return sign + len + 1;
+	}
+	if (-6 < point && point <= 0) {
+		// 1234e-6 -> 0.001234
+		const int offset = 2 - point;
+		memmove(&buf[offset], buf, len);
+		buf[0] = '0';
+		buf[1] = '.';
+		memset(&buf[2], '0', offset - 2);
+		return sign + len + offset;
+	}
+	if (len == 1) {
+		// 1e30
+		return sign + 1 + write_exponent(point - 1, &buf[1]);
+	}
+	// 1234e30 -> 1.234e33
+	memmove(&buf[2], &buf[1], len - 1);
+	buf[1] = '.';
+	return sign + len + 1 + write_exponent(point - 1, &buf[len+1]);
+}
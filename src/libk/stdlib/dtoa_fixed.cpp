@@ -0,0 +1,56 @@
+#include <stdlib.h>
+
+#include <string.h>
+
+namespace {
+
+constexpr uint64_t POW10[DTOA_FIXED_MAX_PRECISION+1] = {
+	1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull,
+	10000000ull, 100000000ull, 1000000000ull, 10000000000ull,
+	100000000000ull, 1000000000000ull, 10000000000000ull,
+	100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+	100000000000000000ull, 1000000000000000000ull,
+};
+
+}
+
+size_t dtoa_fixed(double d, int precision, char *buf) {
+	// too big to go through a uint64_t (and nan and inf)
+	if (!(-1.8e19 < d && d < 1.8e19)) return dtoa(d, buf);
+
+	if (precision < 0) precision = 0;
+	if (precision > DTOA_FIXED_MAX_PRECISION) precision = DTOA_FIXED_MAX_PRECISION;
+
+	size_t len = 0;
+	if (d < 0) {
+		buf[len++] = '-';
+		d = -d;
+	}
+
+	// round to the requested number of digits, carrying into the
+	// integer part if needed
+	uint64_t int_part = d;
+	const uint64_t scale = POW10[precision];
+	const double scaled = (d - int_part) * scale;
+	uint64_t frac_part = scaled + 0.5;
+	// exact halves go to the even digit, like in printf
+	const bool odd = (precision == 0 ? int_part + frac_part : frac_part) & 1;
+	if (odd && frac_part - scaled == 0.5) --frac_part;
+	if (frac_part >= scale) {
+		frac_part -= scale;
+		++int_part;
+	}
+
+	len += utoa64(int_part, &buf[len]);
+	if (precision > 0) {
+		buf[len++] = '.';
+
+		char digits[UTOA64_MAX];
+		const size_t frac_len = utoa64(frac_part, digits);
+		memset(&buf[len], '0', precision - frac_len);
+		memcpy(&buf[len + precision - frac_len], digits, frac_len);
+		len += precision;
+	}
+
+	return len;
+}
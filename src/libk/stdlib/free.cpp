@@ -5,10 +5,18 @@
 
 using namespace _mm_internals;
 
-void free(void *p) {
+void _mm_internals::release(void *p) {
 	//printf("freeing memory at %p\n", p);
 	if (!p) return;
 
+	++stats.num_frees;
+	stats.live_bytes -= usable_size(p);
+
+	if (get_slab(get_idx(p))) {
+		slab_free(p);
+		return;
+	}
+
 	// pointer should point to right after the header structure
 	alloc_header_t *header = (alloc_header_t*)p;
 	--header;
@@ -20,10 +28,10 @@ void free(void *p) {
 	const size_t len = header->s.num_blocks;
 
 	// mark the memory as free
-	for (size_t i = 0; i < len; ++i) {
-		// verify that the memory hasn't already been freed
-		assert(get_used(begin+i) && "double free detected!");
+	// (this also checks that it hasn't already been freed)
+	free_blocks(begin, len);
+}
 
-		set_free(begin+i);
-	}
+void free(void *p) {
+	release(p);
 }
@@ -4,43 +4,54 @@
 
 using namespace _mm_internals;
 
-void *malloc(size_t size) {
+void *_mm_internals::alloc(size_t size, bool zero) {
 	if (size == 0) return NULL;
 
 	//printf("malloc'ing memory of size %d\n", size);
 
+	++stats.num_allocs;
+	++stats.size_buckets[size_bucket(size)];
+
+	// small objects get packed into slabs rather than each getting its
+	// own 1KiB block
+	if (slab_enabled && size <= SLAB_MAX_SIZE) {
+		void *res = slab_alloc(size, zero);
+		stats_add_bytes(slab_size(res));
+		return res;
+	}
+
 	size_t blocks_to_alloc = (size + HEADER_SIZE) / MIN_ALLOC_SIZE;
 	if (blocks_to_alloc*MIN_ALLOC_SIZE < size + HEADER_SIZE) {
 		++blocks_to_alloc;
 	}
+	blocks_to_alloc = round_blocks(blocks_to_alloc);
 
-	// very simple adjustment to make the memory allocator slightly more
-	// likely to result in efficient reallocs
-	constexpr size_t DESIRED_SPACING = NUM_BLOCKS / 512;
-	for (size_t small_step = 0; small_step < DESIRED_SPACING; ++small_step) {
-		for (size_t large_step = 0; large_step < NUM_BLOCKS; large_step += DESIRED_SPACING) {
-			const size_t i = large_step + small_step;
+	const size_t begin = alloc_blocks(blocks_to_alloc);
 
-			alloc_header_t *header;
+	if (begin == num_blocks) {
+		// didn't find a large enough contiguous block of free memory
+		puts("kernel: panic: couldn't allocate required memory!");
+		abort();
+	}
 
-			for (size_t j = 0; j < blocks_to_alloc; ++j) {
-				if (get_used(i+j)) goto no_alloc;
-			}
+	if (zero) {
+		// only clear what isn't known to be clear already
+		// (this has to happen before the header is written)
+		const size_t cleared = zero_dirty_blocks(begin, blocks_to_alloc) * MIN_ALLOC_SIZE;
+		if (cleared < size) stats.zeroing_skipped += size - cleared;
+	}
 
-			for (size_t j = 0; j < blocks_to_alloc; ++j) {
-				set_used(i+j);
-			}
+	alloc_header_t *header = (alloc_header_t*)get_ptr(begin);
+	header->s.num_blocks = blocks_to_alloc;
+	header->s.size = size;
 
-			header = (alloc_header_t*)get_ptr(i);
-			header->s.num_blocks = blocks_to_alloc;
+	stats_add_bytes(blocks_to_alloc*MIN_ALLOC_SIZE - HEADER_SIZE);
 
-			return header+1;
+	return header+1;
+}
 
-		no_alloc:;
-		}
-	}
+void *malloc(size_t size) {
+	_MM_TRACE_CALLER(size);
 
-	// didn't find a large enough contiguous block of free memory
-	puts("kernel: panic: couldn't allocate required memory!");
-	abort();
+	return alloc(size);
 }
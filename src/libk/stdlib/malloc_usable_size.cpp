@@ -0,0 +1,18 @@
+#include <stdlib.h>
+
+using namespace _mm_internals;
+
+size_t malloc_usable_size(void *p) {
+	if (!p) return 0;
+
+	const size_t res = usable_size(p);
+
+	if (!get_slab(get_idx(p))) {
+		// the caller may now use all of it, so realloc needs to
+		// hang on to all of it as well
+		alloc_header_t *header = (alloc_header_t*)p - 1;
+		header->s.size = res;
+	}
+
+	return res;
+}
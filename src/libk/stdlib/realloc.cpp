@@ -6,13 +6,13 @@
 
 using namespace _mm_internals;
 
-void *realloc(void *p, size_t size) {
+void *_mm_internals::resize(void *p, size_t size) {
 	if (size == 0) {
-		free(p);
+		release(p);
 		return NULL;
 	}
 	if (p == NULL) {
-		return malloc(size);
+		return alloc(size);
 	}
 
 	//printf("realloc'ing memory at %p to size %d\n", p, size);
@@ -22,6 +22,32 @@ void *realloc(void *p, size_t size) {
 	// here that that would feel like a waste, so I'm going to actually
 	// implement a proper realloc function
 
+	if (get_slab(get_idx(p))) {
+		// slab objects can't grow in place, but there's no need to
+		// move them if they get smaller or stay within the size class
+		const size_t curr_size = slab_size(p);
+
+		if (size <= curr_size) {
+			++stats.reallocs_in_place;
+			return p;
+		}
+
+		++stats.reallocs_copied;
+
+		void *new_p = alloc(size);
+
+		if (new_p == NULL) {
+			puts("kernel: panic: failed reallocing array");
+			abort();
+		}
+
+		memcpy(new_p, p, curr_size);
+
+		release(p);
+
+		return new_p;
+	}
+
 	// pointer should point to right after the header structure
 	alloc_header_t *header = (alloc_header_t*)p;
 	--header;
@@ -33,24 +59,27 @@ void *realloc(void *p, size_t size) {
 	const size_t curr_len = header->s.num_blocks;
 	size_t req_len = (size + HEADER_SIZE) / MIN_ALLOC_SIZE;
 	if (req_len*MIN_ALLOC_SIZE < size + HEADER_SIZE) ++req_len;
+	req_len = round_blocks(req_len);
 
 	if (req_len == curr_len) {
-		// nothing to do
+		// nothing to do, besides remembering how much is in use
+		header->s.size = size;
+		++stats.reallocs_in_place;
 		return p;
 	} else if (req_len < curr_len) {
 		// shrink memory
 
 		// mark the memory as free
-		for (size_t i = req_len; i < curr_len; ++i) {
-			// verify that the memory hasn't already been freed
-			assert(get_used(begin+i) && "double free detected!");
-
-			set_free(begin+i);
-		}
+		// (this also checks that it hasn't already been freed)
+		shrink_blocks(begin, curr_len, req_len);
 
 		// Very important! Update the no of allocated chunks in the
 		// header
 		header->s.num_blocks = req_len;
+		header->s.size = size;
+
+		++stats.reallocs_in_place;
+		stats.live_bytes -= (curr_len-req_len)*MIN_ALLOC_SIZE;
 
 		return p;
 	} else {
@@ -58,56 +87,61 @@ void *realloc(void *p, size_t size) {
 		// this can actually get complicated:
 		// if there's enough memory available directly afterwards, we
 		// should just grow forwards.
+		// otherwise, if there's enough free memory before and after
+		// the allocation together, we can grow into both and memmove
+		// the contents down, which still beats finding space for a
+		// whole new copy (and works even if there isn't any).
 		// otherwise we should malloc + memcpy + free.
-		// in theory, we could also try expanding backwards *and*
-		// forwards at the same time and using a memmove and our own
-		// custom funky stuff with the headers,
-		// which should prevent a few cases where malloc wouldn't
-		// be able to find enough memory for the realloc but enough
-		// was available if you realloc *over* the old memory, but
-		// that's *way* too much effort rn
-
-		for (size_t i = curr_len; i < req_len; ++i) {
-			if (get_used(begin+i)) {
-				// chunk is used, not enough memory directly
-				// after, need to use the normal lame way
-				goto malloc_memcpy_free;
-			}
-
-			set_used(begin+i);
-			// update the no. of chunks allocated according to the
-			// header already in the loop rather than all at the
-			// end, so that if we only get half way through and
-			// need to do malloc/memcpy/free, all the chunks
-			// now marked as used will be unmarked again by free
-			++header->s.num_blocks;
+
+		if (grow_blocks(begin, curr_len, req_len)) {
+			header->s.num_blocks = req_len;
+			header->s.size = size;
+
+			++stats.reallocs_in_place;
+			stats_add_bytes((req_len-curr_len)*MIN_ALLOC_SIZE);
+
+			return p;
 		}
 
-		return p;
+		const size_t new_begin = grow_blocks_backwards(begin, curr_len, req_len);
+		if (new_begin != num_blocks) {
+			alloc_header_t *new_header = (alloc_header_t*)get_ptr(new_begin);
+
+			// the regions can overlap, so this has to be a memmove
+			memmove(new_header, header, HEADER_SIZE + header->s.size);
 
-	malloc_memcpy_free: // our cool method didn't work :( back to the lame way
-		void *new_p = malloc(size);
+			new_header->s.num_blocks = req_len;
+			new_header->s.size = size;
+
+			++stats.reallocs_in_place;
+			stats_add_bytes((req_len-curr_len)*MIN_ALLOC_SIZE);
+
+			return new_header+1;
+		}
+
+		// not enough free memory around the allocation,
+		// need to use the normal lame way
+		++stats.reallocs_copied;
+
+		void *new_p = alloc(size);
 
 		if (new_p == NULL) {
 			puts("kernel: panic: failed reallocing array");
 			abort();
 		}
 
-		// note that we don't know the exact size of the allocated
-		// data, only the number of 1KiB chunks it has allocated to it;
-		// this means that we have to just memcpy over *all* the
-		// chunks, which is a bit inefficient. But we've got cpu
-		// cycles to spare, and hopefully the previous code block
-		// should work.
-		//
-		// Come to think of it, I should adjust my malloc function
-		// to prefer assigning memory chunks far apart rather than
-		// adjacent, so that the cool method of reallocing has a
-		// better chance of working...
-		memcpy(new_p, p, curr_len * MIN_ALLOC_SIZE);
-
-		free(p);
+		// only what's actually in use needs to be copied over,
+		// not the whole of the last block
+		memcpy(new_p, p, header->s.size);
+
+		release(p);
 
 		return new_p;
 	}
 }
+
+void *realloc(void *p, size_t size) {
+	_MM_TRACE_CALLER(size);
+
+	return resize(p, size);
+}
@@ -3,5 +3,7 @@
 #include <stdio.h>
 
 void *reallocarray(void *p, size_t n, size_t size) {
-	return realloc(p, n*size); // should technically check for overflow...
+	_MM_TRACE_CALLER(n*size);
+
+	return _mm_internals::resize(p, n*size); // should technically check for overflow...
 }
@@ -0,0 +1,22 @@
+#include <stdlib.h>
+
+#include "_conv.hpp"
+
+using namespace _conv_internals;
+
+size_t utoa32(uint32_t value, char *buf) {
+	const size_t len = count_digits(value);
+
+	// from the least significant end, two digits at a time
+	char *p = buf + len;
+	while (value >= 100) {
+		const uint32_t q = div100(value);
+		p -= 2;
+		put_pair(p, value - q*100);
+		value = q;
+	}
+	if (value >= 10) put_pair(p-2, value);
+	else p[-1] = '0' + value;
+
+	return len;
+}
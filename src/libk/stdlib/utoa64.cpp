@@ -0,0 +1,28 @@
+#include <stdlib.h>
+
+#include "_conv.hpp"
+
+using namespace _conv_internals;
+
+size_t utoa64(uint64_t value, char *buf) {
+	if (value <= UINT32_MAX) return utoa32(value, buf);
+
+	// split into chunks of 8 digits, so that the rest can be done with
+	// 32-bit arithmetic
+	const uint64_t upper = div1e8(value);
+	const uint32_t low = uint32_t(value) - uint32_t(upper)*100000000;
+
+	size_t len;
+	if (upper <= UINT32_MAX) {
+		len = utoa32(upper, buf);
+	} else {
+		const uint32_t top = div1e8(upper);
+		const uint32_t middle = uint32_t(upper) - top*100000000;
+		len = utoa32(top, buf);
+		put_8_digits(buf + len, middle);
+		len += 8;
+	}
+	put_8_digits(buf + len, low);
+
+	return len + 8;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// helpers shared by the SSE2 versions of the string functions.
+//
+// The kernel isn't built with -msse2 by default, so these (and the
+// functions using them) are compiled for SSE2 with the target attribute,
+// and are only ever called once _string_internals::init has checked that
+// the CPU supports it.
+//
+// Loads are done 16 bytes at a time from aligned addresses wherever the
+// length isn't known up front, as an aligned load can't cross into the
+// next page (or off the end of memory), even if it reads past the end of
+// the string.
+
+#define SSE2_TARGET __attribute__((target("sse2")))
+
+namespace _string_internals {
+
+typedef char v16qi __attribute__((vector_size(16), may_alias));
+typedef char unaligned_v16qi __attribute__((vector_size(16), may_alias, aligned(1)));
+
+constexpr size_t VEC_SIZE = 16;
+// aligned loads are always safe, but an unaligned one mustn't run over
+// into the next page
+constexpr uintptr_t PAGE_SIZE = 4096;
+
+// set by init, see string.h
+inline bool sse2() {
+#ifdef __SSE2__
+	return true;
+#else
+	return use_sse2;
+#endif
+}
+
+SSE2_TARGET inline v16qi load(const void *aligned) {
+	return *(const v16qi*)aligned;
+}
+SSE2_TARGET inline v16qi loadu(const void *p) {
+	return *(const unaligned_v16qi*)p;
+}
+SSE2_TARGET inline v16qi splat(char c) {
+	return v16qi{ c, c, c, c, c, c, c, c, c, c, c, c, c, c, c, c };
+}
+
+// pcmpeqb + pmovmskb: bit i is set if byte i of a and b are equal
+SSE2_TARGET inline uint32_t eq_mask(v16qi a, v16qi b) {
+	return __builtin_ia32_pmovmskb128((v16qi)(a == b));
+}
+SSE2_TARGET inline uint32_t zero_mask(v16qi a) {
+	return eq_mask(a, v16qi{});
+}
+
+// shared by strcmp (with n = SIZE_MAX) and strncmp
+int strncmp_sse2(const char *s1, const char *s2, size_t n);
+
+}
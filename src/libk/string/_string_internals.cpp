@@ -0,0 +1,35 @@
+#include <string.h>
+
+#include "fpu.hpp"
+
+namespace _string_internals {
+
+bool use_sse2 = false;
+bool use_rep_movsb = false;
+
+namespace {
+
+constexpr uint32_t CPUID_EXT_FEATURES = 7;
+// CPUID leaf 7 feature flags (ebx)
+constexpr uint32_t FEATURE_ERMSB = 1 << 9;
+
+void cpuid(uint32_t leaf, uint32_t &a, uint32_t &b, uint32_t &c, uint32_t &d) {
+	__asm__("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "a"(leaf), "c"(0));
+}
+
+}
+
+void init() {
+	// boot.s only turns SSE on if there's fxsave/fxrstor too
+	use_sse2 = fpu::has(fpu::FEATURE_FXSR | fpu::FEATURE_SSE2);
+
+	uint32_t max_leaf, b, c, d;
+	cpuid(0, max_leaf, b, c, d);
+	if (max_leaf >= CPUID_EXT_FEATURES) {
+		uint32_t a;
+		cpuid(CPUID_EXT_FEATURES, a, b, c, d);
+		use_rep_movsb = b & FEATURE_ERMSB;
+	}
+}
+
+}
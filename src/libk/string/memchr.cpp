@@ -0,0 +1,42 @@
+#include <string.h>
+
+#include "_sse2.hpp"
+
+using namespace _string_internals;
+
+namespace {
+
+SSE2_TARGET void *memchr_sse2(const unsigned char *s, unsigned char c, size_t n) {
+	const v16qi needle = splat(c);
+
+	// start from the aligned block s is in, ignoring what comes before s
+	const unsigned char *p = (const unsigned char*)((uintptr_t)s & ~(VEC_SIZE-1));
+	size_t avail = VEC_SIZE - (s - p);
+	uint32_t found = eq_mask(load(p), needle) >> (s - p);
+
+	for (;;) {
+		if (found) {
+			const size_t i = __builtin_ctz(found);
+			return i < n ? (void*)(s + i) : NULL;
+		}
+		if (n <= avail) return NULL;
+		n -= avail;
+		s += avail;
+		p += VEC_SIZE;
+		avail = VEC_SIZE;
+		found = eq_mask(load(p), needle);
+	}
+}
+
+}
+
+void *memchr(const void *s, int c, size_t n) {
+	const unsigned char *b = (const unsigned char*)s;
+
+	if (n >= VEC_SIZE && sse2()) return memchr_sse2(b, c, n);
+
+	for (size_t i = 0; i < n; ++i) {
+		if (b[i] == (unsigned char)c) return (void*)(b + i);
+	}
+	return NULL;
+}
@@ -1,8 +1,38 @@
 #include <string.h>
 
+#include "_sse2.hpp"
+
+using namespace _string_internals;
+
+namespace {
+
+// the length is known, so unaligned loads can't read past the end
+SSE2_TARGET int memcmp_sse2(const unsigned char *b1, const unsigned char *b2, size_t n) {
+	for (; n >= VEC_SIZE; n -= VEC_SIZE) {
+		const uint32_t same = eq_mask(loadu(b1), loadu(b2));
+		if (same != 0xFFFF) {
+			const size_t i = __builtin_ctz(~same);
+			return b1[i]-b2[i];
+		}
+		b1 += VEC_SIZE;
+		b2 += VEC_SIZE;
+	}
+
+	for (size_t i = 0; i < n; ++i) {
+		if (b1[i]-b2[i]) return b1[i]-b2[i];
+	}
+
+	return 0;
+}
+
+}
+
 int memcmp(const void *s1, const void *s2, size_t n) {
 	const unsigned char *const b1 = (const unsigned char *)s1;
 	const unsigned char *const b2 = (const unsigned char *)s2;
+
+	if (n >= VEC_SIZE && sse2()) return memcmp_sse2(b1, b2, n);
+
 	for (size_t i = 0; i < n; ++i) {
 		if (b1[i]-b2[i]) return b1[i]-b2[i];
 	}
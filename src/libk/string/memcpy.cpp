@@ -2,18 +2,72 @@
 
 #include <stdint.h>
 
-void *memcpy(void *__restrict dest, const void *__restrict src, size_t n) {
-	// TODO: perhaps try optimising by first looping from i = 0 to n/4
-	// and copying 32-bit sections over at a time (using uint32_t),
-	// then doing the last 0-3 one-byte runs at the end with a case?
-	// Also, could 64-bit copying be faster,
-	// even though the cpu is in 32-bit mode?
-	// Also also, how would alignment screw with stuff?
+namespace {
+
+// the source might not end up aligned along with the destination,
+// but x86 doesn't mind unaligned reads (they're just a little slower)
+typedef uint32_t __attribute__((may_alias)) word_t;
+typedef uint32_t __attribute__((may_alias, aligned(1))) unaligned_word_t;
 
+// below this it's not worth lining up the destination to copy words
+constexpr size_t WORD_COPY_MIN = 16;
+// above this `rep movsd` (or `rep movsb`) beats a loop, despite taking a
+// while to get going
+constexpr size_t REP_COPY_MIN = 256;
+
+}
+
+// always copies from low to high addresses, which memmove relies on
+void *memcpy(void *__restrict dest, const void *__restrict src, size_t n) {
 	if (dest == src) return dest;
 
+	uint8_t *d = (uint8_t*)dest;
+	const uint8_t *s = (const uint8_t*)src;
+
+	// with fast strings, `rep movsb` copies whole cache lines at a time
+	// whatever the alignment, so it does everything itself. Without them
+	// it really goes byte by byte, so it's only used for this
+	if (n >= REP_COPY_MIN && _string_internals::use_rep_movsb) {
+		__asm__ volatile(
+			"rep movsb"
+			: "+D"(d), "+S"(s), "+c"(n)
+			:
+			: "memory"
+		);
+		return dest;
+	}
+
+	if (n >= WORD_COPY_MIN) {
+		// copy single bytes until the destination is word aligned
+		const size_t head = -(uintptr_t)d & 3;
+		for (size_t i = 0; i < head; ++i) {
+			*d++ = *s++;
+		}
+		n -= head;
+
+		size_t words = n/4;
+		n &= 3;
+
+		if (words*4 >= REP_COPY_MIN) {
+			__asm__ volatile(
+				"rep movsl"
+				: "+D"(d), "+S"(s), "+c"(words)
+				:
+				: "memory"
+			);
+		} else {
+			for (; words; --words) {
+				*(word_t*)d = *(const unaligned_word_t*)s;
+				d += 4;
+				s += 4;
+			}
+		}
+	}
+
+	// at most 3 bytes are left, which a loop does quicker than
+	// `rep movsb` gets going
 	for (size_t i = 0; i < n; ++i) {
-		((uint8_t*)dest)[i] = ((const uint8_t*)src)[i];
+		d[i] = s[i];
 	}
 
 	return dest;
@@ -2,28 +2,71 @@
 
 #include <stdint.h>
 
-void *memmove(void *dest, const void *src, size_t n) {
-	// TODO: perhaps try optimising by first looping from i = 0 to n/4
-	// and copying 32-bit sections over at a time (using uint32_t),
-	// then doing the last 0-3 one-byte runs at the end with a case?
-	// Also, could 64-bit copying be faster,
-	// even though the cpu is in 32-bit mode?
-	// Also also, how would alignment screw with stuff?
+namespace {
+
+typedef uint32_t __attribute__((may_alias)) word_t;
+typedef uint32_t __attribute__((may_alias, aligned(1))) unaligned_word_t;
 
+// same as in memcpy
+constexpr size_t WORD_COPY_MIN = 16;
+constexpr size_t REP_COPY_MIN = 256;
+
+}
+
+void *memmove(void *dest, const void *src, size_t n) {
 	if (dest == src) return dest;
 
-	if (dest < src) {
-		// copy low bytes first
-		for (size_t i = 0; i < n; ++i) {
-			((uint8_t*)dest)[i] = ((const uint8_t*)src)[i];
+	// memcpy copies low bytes first, so it's safe whenever the
+	// destination comes first or the two don't overlap at all
+	if (dest < src || (const uint8_t*)src + n <= (uint8_t*)dest) {
+		return memcpy(dest, src, n);
+	}
+
+	// otherwise copy high bytes first, working down from the end
+	uint8_t *d = (uint8_t*)dest + n;
+	const uint8_t *s = (const uint8_t*)src + n;
+
+	if (n >= WORD_COPY_MIN) {
+		// copy single bytes until the end of the destination is
+		// word aligned
+		const size_t head = (uintptr_t)d & 3;
+		for (size_t i = 0; i < head; ++i) {
+			*--d = *--s;
 		}
-	} else {
-		// copy high bytes first
-		size_t i = n;
-		while (i --> 0) { // safe down-iter to 0; might be unneeded (is size_t signed?)
-			((uint8_t*)dest)[i] = ((const uint8_t*)src)[i];
+		n -= head;
+
+		size_t words = n/4;
+		n &= 3;
+
+		if (words*4 >= REP_COPY_MIN) {
+			// with the direction flag set, rep movsd goes down from
+			// the word it's pointed at
+			uint8_t *d_word = d - 4;
+			const uint8_t *s_word = s - 4;
+			d -= words*4;
+			s -= words*4;
+			__asm__ volatile(
+				"std\n\t"
+				"rep movsl\n\t"
+				"cld"
+				: "+D"(d_word), "+S"(s_word), "+c"(words)
+				:
+				: "memory", "cc"
+			);
+		} else {
+			for (; words; --words) {
+				d -= 4;
+				s -= 4;
+				*(word_t*)d = *(const unaligned_word_t*)s;
+			}
 		}
 	}
 
+	// at most 3 bytes are left. Fast `rep movsb` only works upwards, so
+	// unlike memcpy there's no using it for the whole thing
+	while (n --> 0) {
+		*--d = *--s;
+	}
+
 	return dest;
 }
@@ -2,9 +2,31 @@
 
 #include <stdint.h>
 
+namespace {
+
+// below this it's not worth lining up the destination to fill words
+constexpr size_t WORD_FILL_MIN = 16;
+
+}
+
 void *memset(void *s, int c, size_t n) {
+	uint8_t *d = (uint8_t*)s;
+
+	if (n >= WORD_FILL_MIN) {
+		// fill single bytes until the destination is word aligned
+		const size_t head = -(uintptr_t)d & 3;
+		for (size_t i = 0; i < head; ++i) {
+			*d++ = c;
+		}
+		n -= head;
+
+		memset32(d, uint32_t(uint8_t(c)) * 0x01010101, n/4);
+		d += n & ~size_t(3);
+		n &= 3;
+	}
+
 	for (size_t i = 0; i < n; ++i) {
-		((uint8_t*)s)[i] = c;
+		d[i] = c;
 	}
 
 	return s;
@@ -0,0 +1,22 @@
+#include <string.h>
+
+#include <stdint.h>
+
+void *memset16(void *s, uint16_t value, size_t count) {
+	uint16_t *d = (uint16_t*)s;
+
+	if (count == 0) return s;
+
+	// fill a single entry if that gets the destination word aligned
+	if ((uintptr_t)d & 2) {
+		*d++ = value;
+		--count;
+	}
+
+	memset32(d, uint32_t(value) | (uint32_t(value) << 16), count/2);
+	d += count & ~size_t(1);
+
+	if (count & 1) *d = value;
+
+	return s;
+}
@@ -0,0 +1,16 @@
+#include <string.h>
+
+#include <stdint.h>
+
+void *memset32(void *s, uint32_t value, size_t count) {
+	void *d = s;
+
+	__asm__ volatile(
+		"rep stosl"
+		: "+D"(d), "+c"(count)
+		: "a"(value)
+		: "memory"
+	);
+
+	return s;
+}
@@ -0,0 +1,39 @@
+#include <string.h>
+
+#include "_sse2.hpp"
+
+using namespace _string_internals;
+
+namespace {
+
+SSE2_TARGET char *strchr_sse2(const char *s, char c) {
+	const v16qi needle = splat(c);
+
+	// start from the aligned block s is in, ignoring what comes before s
+	const char *p = (const char*)((uintptr_t)s & ~(VEC_SIZE-1));
+	v16qi block = load(p);
+	uint32_t stop = (eq_mask(block, needle) | zero_mask(block)) >> (s - p);
+	p = s;
+
+	for (;;) {
+		// either c or the end of the string
+		if (stop) {
+			p += __builtin_ctz(stop);
+			return *p == c ? (char*)p : NULL;
+		}
+		p = (const char*)((uintptr_t)p & ~(VEC_SIZE-1)) + VEC_SIZE;
+		block = load(p);
+		stop = eq_mask(block, needle) | zero_mask(block);
+	}
+}
+
+}
+
+char *strchr(const char *s, int c) {
+	if (sse2()) return strchr_sse2(s, c);
+
+	for (;; ++s) {
+		if (*s == (char)c) return (char*)s;
+		if (*s == 0) return NULL;
+	}
+}
@@ -1,11 +1,15 @@
 #include <string.h>
 
+#include "_sse2.hpp"
+
 int strcmp(const char *s1, const char *s2) {
-	size_t i;
-	for (i = 0; s1[i] != 0 && s2[i] != 0; ++i) {
-		if (s1[i] != s2[i]) return (int)s1[i] - s2[i];
+	if (_string_internals::sse2()) {
+		return _string_internals::strncmp_sse2(s1, s2, SIZE_MAX);
 	}
-	if (s1[i] == 0) return -(int)s2[i];
-	else if (s2[i] == 0) return s1[i];
-	else return 0;
+
+	const unsigned char *a = (const unsigned char*)s1;
+	const unsigned char *b = (const unsigned char*)s2;
+	size_t i;
+	for (i = 0; a[i] != 0 && a[i] == b[i]; ++i);
+	return a[i] - b[i];
 }
@@ -1,6 +1,30 @@
 #include <string.h>
 
+#include "_sse2.hpp"
+
+using namespace _string_internals;
+
+namespace {
+
+SSE2_TARGET size_t strlen_sse2(const char *str) {
+	// start from the aligned block the string starts in, ignoring
+	// whatever comes before the string
+	const char *p = (const char*)((uintptr_t)str & ~(VEC_SIZE-1));
+	uint32_t zeroes = zero_mask(load(p)) >> (str - p);
+	if (zeroes) return __builtin_ctz(zeroes);
+
+	for (;;) {
+		p += VEC_SIZE;
+		zeroes = zero_mask(load(p));
+		if (zeroes) return p - str + __builtin_ctz(zeroes);
+	}
+}
+
+}
+
 size_t strlen(const char *str) {
+	if (sse2()) return strlen_sse2(str);
+
 	size_t len = 0;
 	while (str[len]) ++len;
 	return len;
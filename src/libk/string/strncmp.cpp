@@ -1,8 +1,54 @@
 #include <string.h>
 
+#include "_sse2.hpp"
+
+using namespace _string_internals;
+
+namespace _string_internals {
+
+// s1 is read an aligned block at a time, and s2 unaligned wherever that
+// doesn't cross into a new page (otherwise that block is done bytewise)
+SSE2_TARGET int strncmp_sse2(const char *s1, const char *s2, size_t n) {
+	const unsigned char *a = (const unsigned char*)s1;
+	const unsigned char *b = (const unsigned char*)s2;
+
+	for (; n && ((uintptr_t)a & (VEC_SIZE-1)); --n, ++a, ++b) {
+		if (*a != *b || *a == 0) return *a - *b;
+	}
+
+	while (n) {
+		if (((uintptr_t)b & (PAGE_SIZE-1)) > PAGE_SIZE-VEC_SIZE) {
+			const size_t end = n < VEC_SIZE ? n : VEC_SIZE;
+			for (size_t i = 0; i < end; ++i) {
+				if (a[i] != b[i] || a[i] == 0) return a[i] - b[i];
+			}
+		} else {
+			const v16qi va = load(a);
+			// stop at the first difference or the end of the
+			// string; ~ sets the upper bits, so i is at most 16
+			const uint32_t stop = ~eq_mask(va, loadu(b)) | zero_mask(va);
+			const size_t i = __builtin_ctz(stop);
+			if (i < VEC_SIZE && i < n) return a[i] - b[i];
+		}
+
+		if (n <= VEC_SIZE) break;
+		n -= VEC_SIZE;
+		a += VEC_SIZE;
+		b += VEC_SIZE;
+	}
+
+	return 0;
+}
+
+}
+
 int strncmp(const char *s1, const char *s2, size_t n) {
+	if (n >= VEC_SIZE && sse2()) return strncmp_sse2(s1, s2, n);
+
+	const unsigned char *a = (const unsigned char*)s1;
+	const unsigned char *b = (const unsigned char*)s2;
 	for (size_t i = 0; i < n; ++i) {
-		if (s1[i] != s2[i]) return s1[i] - s2[i];
+		if (a[i] != b[i] || a[i] == 0) return a[i] - b[i];
 	}
 	return 0;
 }
@@ -0,0 +1,86 @@
+#include "multiboot.hpp"
+
+#include <stdio.h>
+
+// from the linker script
+extern "C" uint8_t kernel_start[];
+extern "C" uint8_t kernel_end[];
+
+namespace multiboot {
+
+namespace {
+
+// the first MiB is full of BIOS stuff, VGA memory and the like
+static constexpr uint64_t LOW_MEM_END = 0x00'10'00'00;
+// memory past 4GiB can't be addressed without PAE (and uintptr_t can't
+// hold 4GiB itself), so stop a page short
+static constexpr uint64_t HIGH_MEM_END = 0xFF'FF'F0'00;
+
+// used when booted by something other than a multiboot bootloader:
+// assume there is at least 256MiB of memory from 16MiB up, like the
+// allocator used to
+static constexpr uint64_t FALLBACK_BEGIN = 0x01'00'00'00;
+static constexpr uint64_t FALLBACK_END = FALLBACK_BEGIN + 0x10'00'00'00;
+
+// add [begin, end) to the ranges, minus anything that isn't usable
+void add_range(uint64_t begin, uint64_t end, _mm_internals::mem_range_t *ranges, size_t &count) {
+	if (begin < LOW_MEM_END) begin = LOW_MEM_END;
+	if (end > HIGH_MEM_END) end = HIGH_MEM_END;
+	if (begin >= end) return;
+
+	// cut out the kernel image, which might split the range in two
+	const uint64_t kbegin = uintptr_t(kernel_start);
+	const uint64_t kend = uintptr_t(kernel_end);
+	if (begin < kend && kbegin < end) {
+		add_range(begin, kbegin, ranges, count);
+		add_range(kend, end, ranges, count);
+		return;
+	}
+
+	if (count == MAX_RANGES) {
+		printf("kernel: warning: ignoring memory at 0x%x, too many ranges\n", uint32_t(begin));
+		return;
+	}
+
+	ranges[count].begin = uintptr_t(begin);
+	ranges[count].end = uintptr_t(end);
+	++count;
+}
+
+}
+
+size_t usable_memory(uint32_t magic, const info_t *info, _mm_internals::mem_range_t ranges[MAX_RANGES]) {
+	size_t count = 0;
+
+	if (magic != MULTIBOOT_BOOTLOADER_MAGIC) {
+		puts("kernel: warning: not booted by multiboot, guessing memory layout");
+		add_range(FALLBACK_BEGIN, FALLBACK_END, ranges, count);
+		return count;
+	}
+
+	if (info->flags & MULTIBOOT_INFO_MEM_MAP) {
+		uintptr_t entry_addr = info->mmap_addr;
+		const uintptr_t mmap_end = info->mmap_addr + info->mmap_length;
+		while (entry_addr < mmap_end) {
+			const mmap_entry_t *entry = (const mmap_entry_t*)entry_addr;
+
+			if (entry->type == MULTIBOOT_MEMORY_AVAILABLE) {
+				add_range(entry->addr, entry->addr + entry->len, ranges, count);
+			}
+
+			// the size field doesn't count itself
+			entry_addr += entry->size + sizeof(entry->size);
+		}
+	} else if (info->flags & MULTIBOOT_INFO_MEMORY) {
+		// no memory map, but at least we know how much memory there
+		// is directly above 1MiB
+		add_range(LOW_MEM_END, LOW_MEM_END + uint64_t(info->mem_upper)*1024, ranges, count);
+	} else {
+		puts("kernel: warning: no memory info from bootloader, guessing memory layout");
+		add_range(FALLBACK_BEGIN, FALLBACK_END, ranges, count);
+	}
+
+	return count;
+}
+
+}
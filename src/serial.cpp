@@ -0,0 +1,63 @@
+#include "serial.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ioport.hpp"
+
+namespace {
+	bool present = false;
+
+	// room for this many more bytes in the transmit FIFO
+	size_t fifo_room = 0;
+
+	void send(uint8_t byte) {
+		// the line status only says whether the FIFO is completely
+		// empty, so wait for that and then fill it up without asking
+		// again, instead of polling the port for every byte
+		if (fifo_room == 0) {
+			while (!(inb(SERIAL_LINE_STATUS(COM1)) & SERIAL_STATUS_THR_EMPTY)) { }
+			fifo_room = SERIAL_FIFO_SIZE;
+		}
+		outb(SERIAL_DATA(COM1), byte);
+		--fifo_room;
+	}
+}
+
+namespace serial {
+	bool init() {
+		outb(SERIAL_INT_ENABLE(COM1), 0x00); // no interrupts
+
+		// baud rate divisor 3 (115200/3 = 38400 baud)
+		outb(SERIAL_LINE_CTRL(COM1), SERIAL_LINE_DLAB);
+		outb(SERIAL_DATA(COM1), 3);
+		outb(SERIAL_INT_ENABLE(COM1), 0);
+
+		outb(SERIAL_LINE_CTRL(COM1), SERIAL_LINE_8N1);
+		outb(SERIAL_FIFO_CTRL(COM1), 0xC7); // enable & clear the FIFOs
+		outb(SERIAL_MODEM_CTRL(COM1), 0x0B); // RTS/DSR set
+
+		// check the chip is there (and working) in loopback mode
+		outb(SERIAL_MODEM_CTRL(COM1), 0x1E);
+		outb(SERIAL_DATA(COM1), 0xAE);
+		if (inb(SERIAL_DATA(COM1)) != 0xAE) {
+			present = false;
+			return false;
+		}
+
+		// back to normal operation
+		outb(SERIAL_MODEM_CTRL(COM1), 0x0F);
+		present = true;
+		fifo_room = 0;
+		return true;
+	}
+
+	void write(const char *data, size_t size) {
+		if (!present) return;
+
+		for (size_t i = 0; i < size; ++i) {
+			if (data[i] == '\n') send('\r');
+			send(data[i]);
+		}
+	}
+}
@@ -4,7 +4,6 @@
 #include <stdint.h>
 #include <string.h>
 
-#include <string.h>
 #include "ioport.hpp"
 
 namespace term {
@@ -14,27 +13,128 @@ namespace {
 size_t row;
 size_t col;
 vga::entry_color_t color;
-volatile vga::entry_t *const vga_buffer = (vga::entry_t*)vga::ADDR;
+volatile vga::entry_t *const vga_memory = (vga::entry_t*)vga::ADDR;
 bool move_cursor;
 bool autoscroll;
+bool hardware_scroll;
+
+// VGA memory has room for this many rows, and the screen shows HEIGHT of
+// them starting at screen_row. Hardware scrolling moves the screen down a
+// row at a time, and when it reaches the end of memory the rows still on
+// the screen are moved back up to the top, so memory is used as a ring
+// and the whole screen only gets copied once every ~180 rows
+constexpr size_t MEMORY_ROWS = vga::MEMORY_SIZE / (vga::WIDTH * sizeof(vga::entry_t));
+size_t screen_row;
+// the screen, ie. &vga_memory[screen_row * WIDTH]
+volatile vga::entry_t *vga_buffer = vga_memory;
 volatile vga::entry_t *buffer;
 
+// the columns [dirty_begin, dirty_end) of each row have been drawn to
+// since the (outermost) Backbuffer was created; nothing if begin >= end
+uint8_t dirty_begin[vga::HEIGHT];
+uint8_t dirty_end[vga::HEIGHT];
+
+// present mode, see begin_frame
+alignas(4) vga::entry_t frame[vga::WIDTH*vga::HEIGHT];
+// what's on the screen, unless something else has drawn to it since
+alignas(4) vga::entry_t shadow[vga::WIDTH*vga::HEIGHT];
+bool shadow_valid = false;
+bool in_frame = false;
+bool frame_was_moving_cursor;
+
+// the hardware cursor is only moved once the outermost batch of writes is
+// done (see cursor::sync), rather than after every character
+size_t batch_depth = 0;
+struct Batch {
+	Batch() { ++batch_depth; }
+	~Batch() { if (--batch_depth == 0) cursor::sync(); }
+};
+
+// page flipping, see FlipBuffer: while flipping, term draws into the rows
+// of VGA memory starting at flip_row
+bool flipping = false;
+size_t flip_row;
+
+// shows the rows of VGA memory starting at the given one on the screen
+void set_screen_row(size_t new_row) {
+	const bool on_screen = buffer == vga_buffer;
+
+	screen_row = new_row;
+	vga_buffer = &vga_memory[screen_row * vga::WIDTH];
+	if (on_screen) buffer = vga_buffer;
+
+	// the CRTC start address, in cells
+	const uint16_t start = screen_row * vga::WIDTH;
+	outb(0x3D4, 0x0C);
+	outb(0x3D5, uint8_t(start >> 8));
+	outb(0x3D4, 0x0D);
+	outb(0x3D5, uint8_t(start & 0xFF));
+}
+
+// how far to scroll when running off the bottom of the screen: scrolling
+// in software copies the whole screen, so that's done two rows at a time
+size_t autoscroll_lines() {
+	return hardware_scroll && buffer == vga_buffer ? 1 : 2;
+}
+
+void mark_dirty(size_t index, size_t count) {
+	if (buffer == vga_buffer) {
+		shadow_valid = false;
+		return;
+	}
+
+	while (count) {
+		const size_t y = index / vga::WIDTH;
+		const size_t x = index % vga::WIDTH;
+		const size_t run = count < vga::WIDTH - x ? count : vga::WIDTH - x;
+
+		if (x < dirty_begin[y]) dirty_begin[y] = x;
+		if (x + run > dirty_end[y]) dirty_end[y] = x + run;
+
+		index += run;
+		count -= run;
+	}
+}
+void mark_all_dirty() {
+	if (buffer == vga_buffer) {
+		shadow_valid = false;
+		return;
+	}
+
+	memset(dirty_begin, 0, sizeof(dirty_begin));
+	memset(dirty_end, vga::WIDTH, sizeof(dirty_end));
+}
+
 }
 
 size_t Backbuffer::instance_count = 0;
-Backbuffer::Backbuffer() : was_moving_cursor(move_cursor) {
-	if (instance_count == 0) {
+Backbuffer::Backbuffer(Init init) : was_moving_cursor(move_cursor) {
+	if (instance_count == 0 && !in_frame && !flipping) {
 		::term::buffer = this->buffer;
-		memcpy(this->buffer, (void*)vga_buffer, sizeof(buffer));
+		memset(dirty_begin, vga::WIDTH, sizeof(dirty_begin));
+		memset(dirty_end, 0, sizeof(dirty_end));
+
+		if (init == Init::Clear) clear();
+		else memcpy(this->buffer, (void*)vga_buffer, sizeof(buffer));
 	}
 	++instance_count;
 	move_cursor = false;
 }
 Backbuffer::~Backbuffer() {
 	--instance_count;
-	if (instance_count == 0) {
+	if (instance_count == 0 && !in_frame && !flipping) {
 		::term::buffer = vga_buffer;
-		memcpy((void*)vga_buffer, buffer, sizeof(buffer));
+		shadow_valid = false;
+
+		for (size_t y = 0; y < vga::HEIGHT; ++y) {
+			if (dirty_begin[y] >= dirty_end[y]) continue;
+
+			const size_t index = y * vga::WIDTH + dirty_begin[y];
+			memcpy(
+				(void*)&vga_buffer[index], &buffer[index],
+				(dirty_end[y] - dirty_begin[y]) * sizeof(vga::entry_t)
+			);
+		}
 	}
 	if (was_moving_cursor) {
 		move_cursor = true;
@@ -42,11 +142,87 @@ Backbuffer::~Backbuffer() {
 	}
 }
 
+FlipBuffer::FlipBuffer() : was_moving_cursor(move_cursor) {
+	flipping = true;
+	move_cursor = false;
+
+	// any page which doesn't overlap the screen will do
+	flip_row = screen_row >= vga::HEIGHT ? 0 : 2*vga::HEIGHT;
+	buffer = &vga_memory[flip_row * vga::WIDTH];
+}
+FlipBuffer::~FlipBuffer() {
+	flipping = false;
+	buffer = vga_buffer;
+
+	if (was_moving_cursor) {
+		move_cursor = true;
+		cursor::go_to(col, row);
+	}
+}
+void FlipBuffer::flip(bool wait_for_retrace) {
+	const size_t drawn_row = flip_row;
+	flip_row = screen_row;
+
+	// the start address is latched at the start of vertical retrace, so
+	// set it while the screen is being drawn and then wait for retrace:
+	// after that the old page is off the screen and can be drawn into
+	if (wait_for_retrace) while (inb(0x3DA) & 0x08);
+	set_screen_row(drawn_row);
+	if (wait_for_retrace) while (!(inb(0x3DA) & 0x08));
+
+	buffer = &vga_memory[flip_row * vga::WIDTH];
+	shadow_valid = false;
+	if (was_moving_cursor) cursor::go_to(col, row);
+}
+
+void begin_frame() {
+	if (in_frame || flipping) return;
+
+	// only read the screen when there's no choice, VGA memory is slow
+	if (!shadow_valid) {
+		memcpy(shadow, (void*)vga_buffer, sizeof(shadow));
+		shadow_valid = true;
+	}
+	memcpy(frame, shadow, sizeof(frame));
+
+	in_frame = true;
+	buffer = frame;
+	frame_was_moving_cursor = move_cursor;
+	move_cursor = false;
+}
+void present() {
+	if (!in_frame) return;
+
+	// compare two cells at a time, most of them won't have changed
+	typedef uint32_t __attribute__((may_alias)) cell_pair_t;
+	const cell_pair_t *const frame_pairs = (const cell_pair_t*)frame;
+	const cell_pair_t *const shadow_pairs = (const cell_pair_t*)shadow;
+
+	for (size_t i = 0; i < vga::WIDTH*vga::HEIGHT/2; ++i) {
+		if (frame_pairs[i] == shadow_pairs[i]) continue;
+
+		for (size_t j = 2*i; j < 2*i + 2; ++j) {
+			if (frame[j] != shadow[j]) {
+				vga_buffer[j] = frame[j];
+				shadow[j] = frame[j];
+			}
+		}
+	}
+
+	in_frame = false;
+	buffer = vga_buffer;
+	if (frame_was_moving_cursor) {
+		move_cursor = true;
+		cursor::go_to(col, row);
+	}
+}
+
 void init() {
 	row = 0;
 	col = 0;
 
 	buffer = vga_buffer;
+	set_screen_row(0);
 
 	resetcolor();
 
@@ -57,14 +233,11 @@ void init() {
 	cursor::go_to(0, 0);
 
 	enable_autoscroll();
+	enable_hardware_scroll();
 }
 void clear() {
-	for (size_t y = 0; y < vga::HEIGHT; ++y) {
-		for (size_t x = 0; x < vga::WIDTH; ++x) {
-			const size_t index = y * vga::WIDTH + x;
-			buffer[index] = vga::entry(' ', color);
-		}
-	}
+	memset16((void*)buffer, vga::entry(' ', color), vga::WIDTH*vga::HEIGHT);
+	mark_all_dirty();
 }
 void go_to(size_t x, size_t y) {
 	col = x;
@@ -85,6 +258,7 @@ void resetcolor() {
 void putentryat(vga::entry_t entry, size_t x, size_t y) {
 	const size_t index = y * vga::WIDTH + x;
 	buffer[index] = entry;
+	mark_dirty(index, 1);
 }
 void putbyteat(uint8_t byte, vga::entry_color_t color, size_t x, size_t y) {
 	putentryat(vga::entry(byte, color), x, y);
@@ -95,44 +269,107 @@ void enable_autoscroll() {
 void disable_autoscroll() {
 	autoscroll = false;
 }
-void scroll(size_t lines) {
-	for (size_t y = lines; y < vga::HEIGHT; ++y) {
-		for (size_t x = 0; x < vga::WIDTH; ++x) {
-			const size_t index = y * vga::WIDTH + x;
-			const size_t prev_index = (y-lines) * vga::WIDTH + x;
+void enable_hardware_scroll() {
+	hardware_scroll = true;
+}
+void disable_hardware_scroll() {
+	hardware_scroll = false;
 
-			buffer[prev_index] = buffer[index];
-		}
+	// back to the top of memory, where everything else expects the screen
+	if (screen_row != 0) {
+		memmove(
+			(void*)vga_memory, (void*)vga_buffer,
+			vga::WIDTH*vga::HEIGHT * sizeof(vga::entry_t)
+		);
+		set_screen_row(0);
+		if (move_cursor) cursor::go_to(col, row);
 	}
-	for (size_t y = vga::HEIGHT - lines; y < vga::HEIGHT; ++y) {
-		for (size_t x = 0; x < vga::WIDTH; ++x) {
-			const size_t index = y * vga::WIDTH + x;
-
-			buffer[index] = vga::entry(' ', color);
+}
+void scroll(size_t lines) {
+	const Batch _;
+	if (lines > vga::HEIGHT) lines = vga::HEIGHT;
+
+	if (hardware_scroll && buffer == vga_buffer) {
+		size_t new_row = screen_row + lines;
+		if (new_row + vga::HEIGHT > MEMORY_ROWS) {
+			// out of memory below, so move what stays on the screen
+			// to the top (which is off the screen, so this doesn't
+			// show) and continue from there
+			memmove(
+				(void*)vga_memory, (void*)&vga_buffer[lines * vga::WIDTH],
+				(vga::HEIGHT - lines) * vga::WIDTH * sizeof(vga::entry_t)
+			);
+			new_row = 0;
 		}
+		// clear the rows about to come into view before they do
+		memset16(
+			(void*)&vga_memory[(new_row + vga::HEIGHT - lines) * vga::WIDTH],
+			vga::entry(' ', color), lines * vga::WIDTH
+		);
+		set_screen_row(new_row);
+	} else {
+		memmove(
+			(void*)buffer, (void*)&buffer[lines * vga::WIDTH],
+			(vga::HEIGHT - lines) * vga::WIDTH * sizeof(vga::entry_t)
+		);
+		memset16(
+			(void*)&buffer[(vga::HEIGHT - lines) * vga::WIDTH],
+			vga::entry(' ', color), lines * vga::WIDTH
+		);
 	}
+	mark_all_dirty();
 	row -= lines;
 	if (move_cursor) cursor::go_to(col, row);
 }
 void advance() {
+	const Batch _;
 	if (++col == vga::WIDTH) {
 		col = 0;
 		if (++row == vga::HEIGHT) {
-			if (autoscroll) scroll(2);
+			if (autoscroll) scroll(autoscroll_lines());
 			else row = 0;
 		}
 	}
 	if (move_cursor) cursor::go_to(col, row);
 }
 void putbyte(uint8_t byte) {
+	const Batch _;
 	putbyteat(byte, color, col, row);
 	advance();
 }
+void putbytes(uint8_t byte, size_t count) {
+	const Batch _;
+
+	const vga::entry_t entry = vga::entry(byte, color);
+
+	while (count) {
+		// fill everything up to the last cell of the screen at once,
+		// the last cell goes through putbyte so that it scrolls (or
+		// wraps around) the way it always does
+		const size_t index = row * vga::WIDTH + col;
+		const size_t until_last = vga::WIDTH*vga::HEIGHT-1 - index;
+		const size_t run = count < until_last ? count : until_last;
+
+		memset16((void*)&buffer[index], entry, run);
+		mark_dirty(index, run);
+		col = (index + run) % vga::WIDTH;
+		row = (index + run) / vga::WIDTH;
+		count -= run;
+
+		if (count) {
+			putbyte(byte);
+			--count;
+		}
+	}
+
+	if (move_cursor) cursor::go_to(col, row);
+}
 void putchar(char c) {
+	const Batch _;
 	if (c == '\n') {
 		col = 0;
 		if (++row == vga::HEIGHT) {
-			if (autoscroll) scroll(2);
+			if (autoscroll) scroll(autoscroll_lines());
 			else row = 0;
 		}
 		if (move_cursor) cursor::go_to(col, row);
@@ -141,6 +378,7 @@ void putchar(char c) {
 	}
 }
 void backspace() {
+	const Batch _;
 	if (col == 0) {
 		if (row == 0) return; // no back buffer, so can't go further back
 		else {
@@ -153,41 +391,69 @@ void backspace() {
 	if (move_cursor) cursor::go_to(col, row);
 }
 void write_raw(const uint8_t *data, size_t size) {
-	const bool did_move_cursor = move_cursor;
-	move_cursor = false;
+	const Batch _;
 
 	for (size_t i = 0; i < size; ++i) {
 		putbyte(data[i]);
 	}
-
-	move_cursor = did_move_cursor;
-	if (move_cursor) cursor::go_to(col, row);
 }
 void write(const char *data, size_t size) {
-	const bool did_move_cursor = move_cursor;
-	move_cursor = false;
+	const Batch _;
 
 	for (size_t i = 0; i < size; ++i) {
 		putchar(data[i]);
 	}
-
-	move_cursor = did_move_cursor;
-	if (move_cursor) cursor::go_to(col, row);
 }
 void writestring(const char *str) {
 	write(str, strlen(str));
 }
+volatile vga::entry_t *screen() {
+	return vga_buffer;
+}
 
 namespace cursor {
 
 namespace {
 
+// port I/O is slow (especially in a VM, where each access traps), so what's
+// been written to the cursor registers is remembered, and only changes are
+// written. While the cursor is disabled its position isn't written at all,
+// only once it's enabled again
+
 uint8_t cursor_start = 0;
 uint8_t cursor_end = 0;
 bool enabled = false;
+// whether enabled/cursor_start/cursor_end are what the registers hold,
+// which they aren't until the first enable or disable
+bool shape_known = false;
+
+// where the cursor should be, in VGA memory; only written to the
+// registers by sync
+uint16_t pos = 0;
+bool pos_known = false;
+// what the position registers hold
+uint16_t hardware_pos = 0;
+bool hardware_pos_known = false;
 
 }
 
+void sync() {
+	if (!enabled || !pos_known) return;
+	if (hardware_pos_known && hardware_pos == pos) return;
+
+	if (!hardware_pos_known || uint8_t(hardware_pos) != uint8_t(pos)) {
+		outb(0x3D4, 0x0F);
+		outb(0x3D5, uint8_t(pos & 0xFF));
+	}
+	if (!hardware_pos_known || (hardware_pos >> 8) != (pos >> 8)) {
+		outb(0x3D4, 0x0E);
+		outb(0x3D5, uint8_t(pos >> 8));
+	}
+
+	hardware_pos = pos;
+	hardware_pos_known = true;
+}
+
 uint8_t start() {
 	return cursor_start;
 }
@@ -201,6 +467,8 @@ void enable() {
 	enable(cursor_start, cursor_end);
 }
 void enable(uint8_t start, uint8_t end) {
+	if (shape_known && enabled && start == cursor_start && end == cursor_end) return;
+
 	outb(0x3D4, 0x0A);
 	outb(0x3D5, (inb(0x3D5) & 0xC0) | start);
 
@@ -208,31 +476,43 @@ void enable(uint8_t start, uint8_t end) {
 	outb(0x3D5, (inb(0x3D5) & 0xE0) | end);
 
 	enabled = true;
+	shape_known = true;
 	cursor_start = start;
 	cursor_end = end;
+
+	// catch up with wherever it went while disabled
+	sync();
 }
 void disable() {
+	if (shape_known && !enabled) return;
+
 	outb(0x3D4, 0x0A);
 	outb(0x3D5, 0x20);
 
 	enabled = false;
+	shape_known = true;
 }
 void go_to(size_t x, size_t y) {
-	const uint16_t pos = y * vga::WIDTH + x;
+	// the cursor position is in VGA memory, not on the screen
+	pos = (screen_row + y) * vga::WIDTH + x;
+	pos_known = true;
 
-	outb(0x3D4, 0x0F);
-	outb(0x3D5, uint8_t(pos & 0xFF));
-	outb(0x3D4, 0x0E);
-	outb(0x3D5, uint8_t(pos >> 8));
+	// term syncs once it's done with a batch of writes
+	if (batch_depth == 0) sync();
 }
 uint16_t getpos() {
-	uint16_t pos = 0;
-
-	outb(0x3D4, 0x0F);
-	pos |= inb(0x3D5);
-	outb(0x3D4, 0x0E);
-	pos |= uint16_t(inb(0x3D5)) << 8;
-	return pos;
+	if (!pos_known) {
+		pos = 0;
+		outb(0x3D4, 0x0F);
+		pos |= inb(0x3D5);
+		outb(0x3D4, 0x0E);
+		pos |= uint16_t(inb(0x3D5)) << 8;
+
+		pos_known = true;
+		hardware_pos = pos;
+		hardware_pos_known = true;
+	}
+	return pos - screen_row * vga::WIDTH;
 }
 size_t getx() {
 	return cursor::getpos() % vga::WIDTH;